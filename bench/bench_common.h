@@ -0,0 +1,378 @@
+/*
+* Nombre: bench_common.h
+* Autores:
+  - Andrés Montoya, 21552
+  - Fernanda Esquivel, 21542
+  - Francisco Castillo, 21562
+* Descripción: Piezas comunes de los microbenchmarks: opciones, medición de tiempos, ancho de banda
+  de memoria para el techo del roofline y comparación contra los resúmenes de referencia (golden).
+* Lenguaje: C++
+* Recursos: CLion, OpenMP
+* Historial:
+  - Creado el 17.10.2026
+*/
+
+#ifndef PARALLEL_SCREENSAVER_BENCH_COMMON_H
+#define PARALLEL_SCREENSAVER_BENCH_COMMON_H
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <omp.h>
+
+#include "options.h"
+#include "software_raster.h"
+#include "star_store.h"
+
+// Archivo de referencia por defecto; CMake pasa la ruta dentro del repositorio
+#ifndef BENCH_GOLDEN_FILE
+#define BENCH_GOLDEN_FILE "bench/golden.txt"
+#endif
+
+// Galaxia de la verificación: siempre la misma, sin importar --sizes
+const int kGoldenPoints = 20000;
+const std::uint64_t kGoldenSeed = 1;
+
+struct BenchOptions {
+    std::vector<int> sizes{100000, 1000000};  // Estrellas de cada medición
+    int iterations = 20;                      // Llamadas al kernel por medición
+    int repeats = 3;                          // Se queda la medición más rápida
+    int threads = 0;                          // 0 = los de OpenMP por defecto
+    double tolerance = 1e-3;                  // Diferencia relativa aceptada en los resúmenes
+    std::string goldenPath = BENCH_GOLDEN_FILE;
+    bool updateGolden = false;                // Reescribir las referencias de este benchmark
+    bool skipGolden = false;
+};
+
+inline void printBenchUsage(const char *program) {
+    std::cout << "Uso: " << program << " [opciones]\n"
+              << "  --sizes N,N,...       Estrellas de cada medicion (por defecto 100000,1000000)\n"
+              << "  --iterations N        Llamadas al kernel por medicion (por defecto 20)\n"
+              << "  --repeats N           Repeticiones; se usa la mas rapida (por defecto 3)\n"
+              << "  --threads N           Hilos de OpenMP\n"
+              << "  --tolerance T         Diferencia relativa aceptada contra la referencia (por defecto 0.001)\n"
+              << "  --golden ARCHIVO      Archivo de referencias (por defecto " << BENCH_GOLDEN_FILE << ")\n"
+              << "  --update-golden       Reescribir las referencias de este benchmark con la variante base\n"
+              << "  --no-golden           Solo medir, sin verificar\n"
+              << "  --help                Mostrar esta ayuda\n"
+              << "El CSV sale por la salida estandar y la verificacion por la salida de error.\n";
+}
+
+inline bool parseBenchOptions(int argc, char **argv, BenchOptions &options) {
+    for (int i = 1; i < argc; ++i) {
+        const char *arg = argv[i];
+        double value = 0.0;
+
+        if (std::strcmp(arg, "--help") == 0 || std::strcmp(arg, "-h") == 0) {
+            printBenchUsage(argv[0]);
+            return false;
+        } else if (std::strcmp(arg, "--sizes") == 0) {
+            if (!readList(argc, argv, i, 1, static_cast<int>(kMaxLargePoints), options.sizes)) return false;
+        } else if (std::strcmp(arg, "--iterations") == 0) {
+            if (!readValue(argc, argv, i, value) || !checkRange(arg, value, 1, 1000000)) return false;
+            options.iterations = static_cast<int>(value);
+        } else if (std::strcmp(arg, "--repeats") == 0) {
+            if (!readValue(argc, argv, i, value) || !checkRange(arg, value, 1, 1000)) return false;
+            options.repeats = static_cast<int>(value);
+        } else if (std::strcmp(arg, "--threads") == 0) {
+            if (!readValue(argc, argv, i, value) || !checkRange(arg, value, 1, 4096)) return false;
+            options.threads = static_cast<int>(value);
+        } else if (std::strcmp(arg, "--tolerance") == 0) {
+            if (!readValue(argc, argv, i, value) || !checkRange(arg, value, 0.0, 1.0)) return false;
+            options.tolerance = value;
+        } else if (std::strcmp(arg, "--golden") == 0) {
+            if (i + 1 >= argc) {
+                std::cerr << "Falta el valor de --golden\n";
+                return false;
+            }
+            options.goldenPath = argv[++i];
+        } else if (std::strcmp(arg, "--update-golden") == 0) {
+            options.updateGolden = true;
+        } else if (std::strcmp(arg, "--no-golden") == 0) {
+            options.skipGolden = true;
+        } else {
+            std::cerr << "Opcion desconocida: " << arg << "\n";
+            printBenchUsage(argv[0]);
+            return false;
+        }
+    }
+    if (options.threads > 0) {
+        omp_set_num_threads(options.threads);
+    }
+    return true;
+}
+
+// Segundos de la más rápida de repeats corridas de run(); setup() prepara cada corrida fuera del tiempo
+template <typename Setup, typename Run>
+double bestSeconds(int repeats, Setup setup, Run run) {
+    double best = std::numeric_limits<double>::infinity();
+    for (int r = 0; r < repeats; ++r) {
+        setup();
+        auto start = std::chrono::steady_clock::now();
+        run();
+        best = std::min(best, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+    }
+    return best;
+}
+
+// Ancho de banda de memoria alcanzable, en bytes por nanosegundo (= GB/s), sobre arreglos mucho
+// más grandes que la caché. Se toma el mejor de dos patrones: la suma escalada de STREAM
+// (a = b + s·c, 12 bytes por elemento) y el de la actualización de las estrellas (dos arreglos
+// que se leen y reescriben y dos que solo se escriben, 24 bytes). Con más flujos el procesador
+// sostiene más accesos a la vez, así que solo con STREAM el kernel podría pasar el techo.
+// Como en STREAM, no se cuenta la lectura previa de las líneas que solo se escriben. Se mide una vez.
+inline double memoryBandwidth() {
+    static const double bandwidth = [] {
+        const std::size_t count = std::size_t(1) << 24;  // 64 MB por arreglo
+        std::vector<float> a(count, 1.0f), b(count, 2.0f), c(count, 0.0f), d(count, 0.0f);
+        long long n = static_cast<long long>(count);
+        auto best = [](auto kernel) {
+            double seconds = std::numeric_limits<double>::infinity();
+            for (int r = 0; r < 5; ++r) {
+                auto start = std::chrono::steady_clock::now();
+                kernel();
+                seconds = std::min(seconds, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+            }
+            return seconds;
+        };
+        double triad = best([&] {
+#pragma omp parallel for simd schedule(static)
+            for (long long i = 0; i < n; ++i) {
+                c[i] = a[i] + 3.0f * b[i];
+            }
+        });
+        double update = best([&] {
+#pragma omp parallel for simd schedule(static)
+            for (long long i = 0; i < n; ++i) {
+                float r = a[i] * 0.999f, t = b[i] + 0.001f;
+                a[i] = r;
+                b[i] = t;
+                c[i] = r * t;
+                d[i] = r - t;
+            }
+        });
+        volatile float sink = c[count / 2] + d[count / 2];
+        (void)sink;
+        return std::max(12.0 * count / (triad * 1e9), 24.0 * count / (update * 1e9));
+    }();
+    return bandwidth;
+}
+
+inline void printBenchHeader() {
+    std::cout << "kernel,variante,estrellas,hilos,ns_por_estrella,millones_por_s,bytes_por_estrella,conjunto_mb,"
+                 "gb_por_s,techo_ns_por_estrella,fraccion_del_techo\n";
+}
+
+// Una fila del CSV. bytesPerStar es el tráfico de memoria mínimo por estrella del kernel
+// (ver cada benchmark); con él el techo es lo que tardaría si solo lo limitara la memoria.
+// Sin tráfico que medir (bytesPerStar = 0) el techo queda vacío. Si el conjunto de trabajo cabe
+// en la caché la fracción puede pasar de 1: el techo es el de la memoria principal.
+inline void printBenchRow(const char *kernel, const std::string &variant, long long items, double seconds,
+                          int iterations, double bytesPerStar) {
+    double ns = seconds * 1e9 / (static_cast<double>(items) * iterations);
+    std::cout << kernel << ',' << variant << ',' << items << ',' << omp_get_max_threads() << ','
+              << ns << ',' << 1e3 / ns << ',' << bytesPerStar << ',' << bytesPerStar * items / 1e6 << ',';
+    if (bytesPerStar > 0.0) {
+        double roof = bytesPerStar / memoryBandwidth();
+        std::cout << bytesPerStar / ns << ',' << roof << ',' << roof / ns << '\n';
+    } else {
+        std::cout << ",,\n";
+    }
+    std::cout.flush();
+}
+
+// ---------------------------------------------------------------- Referencias
+
+// Resumen de un resultado: un hash exacto y unas pocas estadísticas. Si el hash cambia pero las
+// estadísticas quedan dentro de la tolerancia, el resultado se acepta como equivalente (p. ej.
+// otro conjunto de instrucciones que redondea distinto el seno).
+struct GoldenDigest {
+    std::uint64_t hash = 14695981039346656037ULL;  // FNV-1a de 64 bits
+    std::vector<double> stats;
+
+    void add(const void *data, std::size_t bytes) {
+        const std::uint8_t *p = static_cast<const std::uint8_t *>(data);
+        for (std::size_t k = 0; k < bytes; ++k) {
+            hash = (hash ^ p[k]) * 1099511628211ULL;
+        }
+    }
+
+    template <typename T>
+    void add(const T &value) {
+        add(&value, sizeof(value));
+    }
+};
+
+// Estado de la galaxia: posiciones a 1/16 de píxel, generación y color, en el orden de
+// generación. Estadísticas: x e y medias, radio medio y generación media; los segundos
+// momentos alrededor de la media (xx, yy, xy), que cambian si la galaxia queda girada o
+// reflejada; y x e y ponderadas por el índice de la estrella (k/n - ½), que cambian si las
+// estrellas quedan en otro lugar aunque la nube completa se vea igual.
+inline GoldenDigest digestStars(const StarStore &stars) {
+    GoldenDigest digest;
+    std::size_t n = stars.count();
+    std::vector<std::size_t> at(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        at[stars.idOf(i)] = i;
+    }
+    double sx = 0, sy = 0, sr = 0, sg = 0;
+    for (std::size_t k = 0; k < n; ++k) {
+        std::size_t i = at[k];
+        digest.add(static_cast<std::int32_t>(std::lround(stars.x[i] * 16.0f)));
+        digest.add(static_cast<std::int32_t>(std::lround(stars.y[i] * 16.0f)));
+        digest.add(stars.generation[i]);
+        digest.add(stars.palette[i]);
+        sx += stars.x[i];
+        sy += stars.y[i];
+        sr += stars.radius[i];
+        sg += stars.generation[i];
+    }
+    double mx = sx / n, my = sy / n;
+    double sxx = 0, syy = 0, sxy = 0, wx = 0, wy = 0;
+    for (std::size_t k = 0; k < n; ++k) {
+        std::size_t i = at[k];
+        double dx = stars.x[i] - mx, dy = stars.y[i] - my;
+        double w = static_cast<double>(k) / n - 0.5;
+        sxx += dx * dx;
+        syy += dy * dy;
+        sxy += dx * dy;
+        wx += w * dx;
+        wy += w * dy;
+    }
+    digest.stats = {mx, my, sr / n, sg / n, sxx / n, syy / n, sxy / n, wx / n, wy / n};
+    return digest;
+}
+
+// Frame: los bytes exactos. Estadísticas: promedio por canal, fracción de píxeles encendidos,
+// la fracción encendida de cada cuadrante y el momento xy del brillo alrededor del centro
+// (en píxeles²), que cambian si la imagen queda girada o reflejada.
+inline GoldenDigest digestFrame(const Framebuffer &frame) {
+    GoldenDigest digest;
+    digest.add(frame.pixels.data(), frame.pixels.size());
+    double sum[3] = {0, 0, 0};
+    std::size_t lit = 0, pixels = static_cast<std::size_t>(frame.width) * frame.height;
+    std::size_t quadrant[4] = {0, 0, 0, 0};
+    double cx = 0.5 * frame.width, cy = 0.5 * frame.height;
+    double brightness = 0, momentXY = 0;
+    for (int py = 0; py < frame.height; ++py) {
+        for (int px = 0; px < frame.width; ++px) {
+            const std::uint8_t *rgb = &frame.pixels[(static_cast<std::size_t>(py) * frame.width + px) * 3];
+            sum[0] += rgb[0];
+            sum[1] += rgb[1];
+            sum[2] += rgb[2];
+            bool on = (rgb[0] | rgb[1] | rgb[2]) != 0;
+            lit += on;
+            quadrant[(px >= cx ? 1 : 0) + (py >= cy ? 2 : 0)] += on;
+            double value = rgb[0] + rgb[1] + rgb[2];
+            brightness += value;
+            momentXY += value * (px + 0.5 - cx) * (py + 0.5 - cy);
+        }
+    }
+    double quarter = pixels / 4.0;
+    digest.stats = {sum[0] / pixels, sum[1] / pixels, sum[2] / pixels, static_cast<double>(lit) / pixels,
+                    quadrant[0] / quarter, quadrant[1] / quarter, quadrant[2] / quarter, quadrant[3] / quarter,
+                    brightness > 0 ? momentXY / brightness : 0.0};
+    return digest;
+}
+
+// Archivo de referencias: una línea por resultado, "nombre hash estadística...". Cada benchmark
+// solo reescribe sus propias líneas.
+class GoldenFile {
+public:
+    explicit GoldenFile(const BenchOptions &options) : options_(options) {
+        std::ifstream in(options.goldenPath);
+        std::string line;
+        while (std::getline(in, line)) {
+            if (line.empty() || line[0] == '#') {
+                continue;
+            }
+            std::istringstream fields(line);
+            std::string name, hash;
+            GoldenDigest digest;
+            fields >> name >> hash;
+            digest.hash = std::strtoull(hash.c_str(), nullptr, 16);
+            double value;
+            while (fields >> value) {
+                digest.stats.push_back(value);
+            }
+            entries_[name] = digest;
+        }
+        if (!options.skipGolden && !options.updateGolden && entries_.empty()) {
+            std::cerr << "Sin referencias en " << options.goldenPath << " (usar --update-golden para crearlas)\n";
+        }
+    }
+
+    // Compara el resultado de una variante con la referencia name. Con --update-golden la
+    // primera variante que llega (la base) se vuelve la referencia.
+    void check(const std::string &name, const std::string &variant, const GoldenDigest &digest) {
+        if (options_.skipGolden) {
+            return;
+        }
+        if (options_.updateGolden && updated_.insert(std::make_pair(name, true)).second) {
+            entries_[name] = digest;
+        }
+        auto found = entries_.find(name);
+        const char *verdict;
+        double worst = 0.0;
+        if (found == entries_.end()) {
+            verdict = "sin_referencia";
+            failed_ = true;
+        } else if (found->second.hash == digest.hash) {
+            verdict = "exacto";
+        } else {
+            const std::vector<double> &reference = found->second.stats;
+            bool same = reference.size() == digest.stats.size();
+            for (std::size_t k = 0; same && k < reference.size(); ++k) {
+                double difference = std::fabs(digest.stats[k] - reference[k]) / std::max(1.0, std::fabs(reference[k]));
+                worst = std::max(worst, difference);
+            }
+            same = same && worst <= options_.tolerance;
+            verdict = same ? "tolerancia" : "FALLA";
+            failed_ = failed_ || !same;
+        }
+        std::cerr << "golden," << name << ',' << variant << ',' << verdict << ',' << std::hex << std::setw(16)
+                  << std::setfill('0') << digest.hash << std::dec << std::setfill(' ') << ",diferencia=" << worst
+                  << '\n';
+    }
+
+    // Guarda el archivo si se pidió actualizarlo; devuelve el código de salida del benchmark
+    int finish() const {
+        if (options_.updateGolden) {
+            std::ofstream out(options_.goldenPath);
+            out << "# Referencias de los microbenchmarks (bench/). Se reescriben con --update-golden.\n"
+                << "# nombre hash_fnv1a estadisticas...\n";
+            for (const auto &entry : entries_) {
+                out << entry.first << ' ' << std::hex << std::setw(16) << std::setfill('0') << entry.second.hash
+                    << std::dec << std::setfill(' ') << std::setprecision(10);
+                for (double value : entry.second.stats) {
+                    out << ' ' << value;
+                }
+                out << '\n';
+            }
+            if (!out) {
+                std::cerr << "No se pudo escribir " << options_.goldenPath << "\n";
+                return 1;
+            }
+        }
+        return failed_ ? 1 : 0;
+    }
+
+private:
+    const BenchOptions &options_;
+    std::map<std::string, GoldenDigest> entries_;
+    std::map<std::string, bool> updated_;
+    bool failed_ = false;
+};
+
+#endif //PARALLEL_SCREENSAVER_BENCH_COMMON_H
@@ -0,0 +1,73 @@
+/*
+ * Nombre: bench_extra_stars.cpp
+ * Autores:
+   - Andrés Montoya, 21552
+   - Fernanda Esquivel, 21542
+   - Francisco Castillo, 21562
+ * Descripción: Microbenchmark del ciclo de vida de las estrellas adicionales (desvanecer, reciclar
+   y generar) para varias tasas, verificado contra la referencia.
+ * Lenguaje: C++
+ * Recursos: CLion
+ * Historial:
+   - Creado el 17.10.2026
+*/
+
+#include <cstdint>
+#include <string>
+
+#include "bench/bench_common.h"
+#include "extra_stars.h"
+
+// Frames de 1/60 s de la verificación
+const int kGoldenFrames = 600;
+const float kFrameTime = 1.0f / 60.0f;
+
+// Cada frame lee y escribe el tiempo restante de cada estrella viva
+const double kExtraBytes = 2 * sizeof(float);
+
+int main(int argc, char **argv) {
+    BenchOptions options;
+    if (!parseBenchOptions(argc, argv, options)) {
+        return 1;
+    }
+    GoldenFile golden(options);
+
+    GalaxyParams params;
+    params.seed = kGoldenSeed;
+    ExtraStarPool reference(100.0f);
+    for (int f = 0; f < kGoldenFrames; ++f) {
+        reference.update(kFrameTime, params);
+    }
+    GoldenDigest digest;
+    double sx = 0, sy = 0, sa = 0;
+    for (std::size_t k = 0; k < reference.count(); ++k) {
+        float x = reference.x(k), y = reference.y(k);
+        std::uint8_t alpha = reference.alpha(k);
+        digest.add(x);
+        digest.add(y);
+        digest.add(alpha);
+        sx += x;
+        sy += y;
+        sa += alpha;
+    }
+    double n = static_cast<double>(reference.count());
+    digest.stats = {n, sx / n, sy / n, sa / n};
+    golden.check("extra", "serie", digest);
+
+    // Aquí --sizes son estrellas vivas: la tasa que las sostiene con 1.5 s de vida
+    printBenchHeader();
+    for (int size : options.sizes) {
+        ExtraStarPool pool(size / 1.5f);
+        for (int f = 0; f < 120; ++f) {
+            pool.update(kFrameTime, params); // Llenar el búfer
+        }
+        long long alive = static_cast<long long>(pool.count());
+        double seconds = bestSeconds(options.repeats, [] {}, [&] {
+            for (int k = 0; k < options.iterations; ++k) {
+                pool.update(kFrameTime, params);
+            }
+        });
+        printBenchRow("extra", "update", alive, seconds, options.iterations, kExtraBytes);
+    }
+    return golden.finish();
+}
@@ -0,0 +1,59 @@
+/*
+ * Nombre: bench_init.cpp
+ * Autores:
+   - Andrés Montoya, 21552
+   - Fernanda Esquivel, 21542
+   - Francisco Castillo, 21562
+ * Descripción: Microbenchmark de la generación de las estrellas con cada política paralela,
+   verificado contra la galaxia de referencia.
+ * Lenguaje: C++
+ * Recursos: CLion, OpenMP
+ * Historial:
+   - Creado el 17.10.2026
+*/
+
+#include <string>
+
+#include "bench/bench_common.h"
+#include "galaxy.h"
+
+// Escribe radio, ángulo, tamaño, x, y (float), generación (uint32) y color (uint16)
+const double kInitBytes = 6 * sizeof(float) + sizeof(std::uint16_t);
+
+int main(int argc, char **argv) {
+    BenchOptions options;
+    if (!parseBenchOptions(argc, argv, options)) {
+        return 1;
+    }
+    GoldenFile golden(options);
+    const ParallelBackend backends[] = {ParallelBackend::OmpStatic, ParallelBackend::OmpDynamic, ParallelBackend::Pool};
+
+    GalaxyParams params;
+    params.seed = kGoldenSeed;
+    for (ParallelBackend backend : backends) {
+        ParallelPolicy policy;
+        policy.backend = backend;
+        StarStore stars;
+        stars.resize(kGoldenPoints);
+        initGalaxy(stars, params, policy);
+        golden.check("init", parallelBackendName(backend), digestStars(stars));
+    }
+
+    printBenchHeader();
+    for (int size : options.sizes) {
+        for (ParallelBackend backend : backends) {
+            ParallelPolicy policy;
+            policy.backend = backend;
+            StarStore stars;
+            stars.resize(size);
+            initGalaxy(stars, params, policy); // Primer acceso a la memoria fuera del tiempo
+            double seconds = bestSeconds(options.repeats, [] {}, [&] {
+                for (int k = 0; k < options.iterations; ++k) {
+                    initGalaxy(stars, params, policy);
+                }
+            });
+            printBenchRow("init", parallelBackendName(backend), size, seconds, options.iterations, kInitBytes);
+        }
+    }
+    return golden.finish();
+}
@@ -0,0 +1,98 @@
+/*
+ * Nombre: bench_palette.cpp
+ * Autores:
+   - Andrés Montoya, 21552
+   - Fernanda Esquivel, 21542
+   - Francisco Castillo, 21562
+ * Descripción: Microbenchmark del mapeo de color: de cada estrella a su color RGB por la tabla de
+   la paleta, con el color guardado o siguiendo al radio, para cada paleta.
+ * Lenguaje: C++
+ * Recursos: CLion, OpenMP
+ * Historial:
+   - Creado el 17.10.2026
+*/
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "bench/bench_common.h"
+#include "galaxy.h"
+#include "palette.h"
+
+// El color de cada estrella en rgb (3 bytes por estrella), como lo hace el lote de vértices
+void mapColors(const StarStore &stars, const Palette &palette, std::vector<std::uint8_t> &rgb) {
+    long long n = static_cast<long long>(stars.count());
+    rgb.resize(static_cast<std::size_t>(n) * 3);
+#pragma omp parallel for schedule(static)
+    for (long long i = 0; i < n; ++i) {
+        const PaletteColor &color = palette.colorOf(stars, static_cast<std::size_t>(i));
+        rgb[i * 3] = color.r;
+        rgb[i * 3 + 1] = color.g;
+        rgb[i * 3 + 2] = color.b;
+    }
+}
+
+int main(int argc, char **argv) {
+    BenchOptions options;
+    if (!parseBenchOptions(argc, argv, options)) {
+        return 1;
+    }
+    GoldenFile golden(options);
+
+    GalaxyParams params;
+    params.seed = kGoldenSeed;
+    StarStore reference;
+    reference.resize(kGoldenPoints);
+    initGalaxy(reference, params);
+    std::vector<std::uint8_t> rgb;
+    for (int kind = 0; kind < static_cast<int>(PaletteKind::Count); ++kind) {
+        for (int follow = 0; follow < 2; ++follow) {
+            Palette palette(static_cast<PaletteKind>(kind));
+            palette.setColorFollowsRadius(follow != 0, params.maxRadius);
+            mapColors(reference, palette, rgb);
+            GoldenDigest digest;
+            digest.add(rgb.data(), rgb.size());
+            double sum[3] = {0, 0, 0};
+            for (std::size_t i = 0; i < rgb.size(); i += 3) {
+                sum[0] += rgb[i];
+                sum[1] += rgb[i + 1];
+                sum[2] += rgb[i + 2];
+            }
+            digest.stats = {sum[0] / kGoldenPoints, sum[1] / kGoldenPoints, sum[2] / kGoldenPoints};
+            std::string name = std::string("color/") + paletteName(static_cast<PaletteKind>(kind)) +
+                               (follow ? "/radio" : "/indice");
+            golden.check(name, "tabla", digest);
+        }
+    }
+
+    printBenchHeader();
+    for (int size : options.sizes) {
+        StarStore stars;
+        stars.resize(size);
+        initGalaxy(stars, params);
+        for (int follow = 0; follow < 2; ++follow) {
+            Palette palette;
+            palette.setColorFollowsRadius(follow != 0, params.maxRadius);
+            mapColors(stars, palette, rgb);
+            double seconds = bestSeconds(options.repeats, [] {}, [&] {
+                for (int k = 0; k < options.iterations; ++k) {
+                    mapColors(stars, palette, rgb);
+                }
+            });
+            // Lee el índice (2 bytes) o el radio (4) y escribe 3
+            double bytes = (follow ? sizeof(float) : sizeof(std::uint16_t)) + 3.0;
+            printBenchRow("color", follow ? "radio" : "indice", size, seconds, options.iterations, bytes);
+        }
+    }
+
+    // Recalcular la tabla completa al cambiar de paleta (por entrada, sin techo de memoria)
+    Palette palette;
+    double seconds = bestSeconds(options.repeats, [] {}, [&] {
+        for (int k = 0; k < options.iterations; ++k) {
+            palette.cycle();
+        }
+    });
+    printBenchRow("color", "tabla", kPaletteLevels, seconds, options.iterations, 0.0);
+    return golden.finish();
+}
@@ -0,0 +1,109 @@
+/*
+ * Nombre: bench_render.cpp
+ * Autores:
+   - Andrés Montoya, 21552
+   - Fernanda Esquivel, 21542
+   - Francisco Castillo, 21562
+ * Descripción: Microbenchmark del dibujo en CPU: rasterizador por mosaicos y dibujo por densidad,
+   con las estrellas en el orden de generación o en orden espacial, verificados contra los frames
+   de referencia.
+ * Lenguaje: C++
+ * Recursos: CLion, OpenMP
+ * Historial:
+   - Creado el 17.10.2026
+*/
+
+#include <string>
+
+#include "bench/bench_common.h"
+#include "density.h"
+#include "galaxy.h"
+#include "software_raster.h"
+#include "spatial_order.h"
+#include "time_step.h"
+
+// Frames simulados antes de dibujar la verificación, para que haya reapariciones
+const int kGoldenFrames = 120;
+
+// Lee x, y, tamaño (float) y color (uint16) de cada estrella. El framebuffer (800x800) y las
+// listas por mosaico no se cuentan: el techo es el de leer las estrellas.
+const double kRenderBytes = 3 * sizeof(float) + sizeof(std::uint16_t);
+
+struct RenderVariant {
+    const char *name;
+    const char *golden;  // Referencia con la que se compara
+    bool density;
+    bool spatialOrder;
+};
+
+const RenderVariant kRenderVariants[] = {
+    {"mosaicos", "render/mosaicos", false, false},
+    {"mosaicos-orden-espacial", "render/mosaicos", false, true},
+    {"densidad", "render/densidad", true, false},
+    {"densidad-orden-espacial", "render/densidad", true, true},
+};
+
+int main(int argc, char **argv) {
+    BenchOptions options;
+    if (!parseBenchOptions(argc, argv, options)) {
+        return 1;
+    }
+    GoldenFile golden(options);
+    Palette palette;
+    ExtraStarPool noExtraStars(0.0f);
+    SpatialOrder order(800, 800, 1);
+
+    GalaxyParams params;
+    params.seed = kGoldenSeed;
+    for (const RenderVariant &variant : kRenderVariants) {
+        StarStore stars;
+        stars.resize(kGoldenPoints);
+        initGalaxy(stars, params);
+        advanceGalaxy(stars, params, kGoldenFrames);
+        if (variant.spatialOrder) {
+            order.reorder(stars);
+        }
+        Framebuffer frame;
+        if (variant.density) {
+            DensityRenderer renderer;
+            renderer.render(stars, palette, frame);
+        } else {
+            TiledRasterizer rasterizer;
+            rasterizer.render(stars, palette, noExtraStars, frame);
+        }
+        golden.check(variant.golden, variant.name, digestFrame(frame));
+    }
+
+    printBenchHeader();
+    for (int size : options.sizes) {
+        StarStore stars;
+        stars.resize(size);
+        initGalaxy(stars, params);
+        advanceGalaxy(stars, params, kGoldenFrames);
+        for (const RenderVariant &variant : kRenderVariants) {
+            if (variant.spatialOrder) {
+                order.reorder(stars);
+            } else {
+                restoreGenerationOrder(stars);
+            }
+            Framebuffer frame;
+            DensityRenderer density;
+            TiledRasterizer rasterizer;
+            auto draw = [&] {
+                if (variant.density) {
+                    density.render(stars, palette, frame);
+                } else {
+                    rasterizer.render(stars, palette, noExtraStars, frame);
+                }
+            };
+            draw(); // Reservar los búferes fuera del tiempo
+            double seconds = bestSeconds(options.repeats, [] {}, [&] {
+                for (int k = 0; k < options.iterations; ++k) {
+                    draw();
+                }
+            });
+            printBenchRow("render", variant.name, size, seconds, options.iterations, kRenderBytes);
+        }
+    }
+    return golden.finish();
+}
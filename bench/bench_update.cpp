@@ -0,0 +1,100 @@
+/*
+ * Nombre: bench_update.cpp
+ * Autores:
+   - Andrés Montoya, 21552
+   - Fernanda Esquivel, 21542
+   - Francisco Castillo, 21562
+ * Descripción: Microbenchmark del paso de actualización de la espiral: cada conjunto de instrucciones,
+   el avance en forma cerrada y la rotación incremental, verificados contra la misma referencia.
+ * Lenguaje: C++
+ * Recursos: CLion, OpenMP
+ * Historial:
+   - Creado el 17.10.2026
+*/
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "bench/bench_common.h"
+#include "galaxy.h"
+#include "incremental_rotation.h"
+#include "time_step.h"
+
+// Lee radio y ángulo y escribe radio, ángulo, x e y (las reapariciones son raras)
+const double kUpdateBytes = 6 * sizeof(float);
+
+// Frames de la verificación: suficientes para que casi todas las estrellas reaparezcan
+const int kGoldenFrames = 600;
+
+struct UpdateVariant {
+    std::string name;
+    // Crea el paso; cada variante puede guardar estado propio (p. ej. la rotación incremental)
+    std::function<std::function<void(StarStore &, const GalaxyParams &)>()> make;
+};
+
+std::vector<UpdateVariant> updateVariants() {
+    std::vector<UpdateVariant> variants;
+    // La referencia es el kernel escalar: la que menos depende del procesador
+    const SimdLevel levels[] = {SimdLevel::Scalar, SimdLevel::SSE2, SimdLevel::AVX2, SimdLevel::AVX512};
+    for (SimdLevel level : levels) {
+        if (resolveSimdLevel(level) != level) {
+            continue;
+        }
+        variants.push_back({simdLevelName(level), [level] {
+            return std::function<void(StarStore &, const GalaxyParams &)>(
+                    [level](StarStore &stars, const GalaxyParams &params) { updateGalaxy(stars, params, level); });
+        }});
+    }
+    variants.push_back({"cerrado", [] {
+        return std::function<void(StarStore &, const GalaxyParams &)>(
+                [](StarStore &stars, const GalaxyParams &params) { advanceGalaxy(stars, params, 1.0); });
+    }});
+    variants.push_back({"incremental", [] {
+        std::shared_ptr<IncrementalRotation> incremental = std::make_shared<IncrementalRotation>(SimdLevel::Auto, ParallelPolicy());
+        return std::function<void(StarStore &, const GalaxyParams &)>(
+                [incremental](StarStore &stars, const GalaxyParams &params) { incremental->advance(stars, params, 0.0); });
+    }});
+    return variants;
+}
+
+int main(int argc, char **argv) {
+    BenchOptions options;
+    if (!parseBenchOptions(argc, argv, options)) {
+        return 1;
+    }
+    GoldenFile golden(options);
+    std::vector<UpdateVariant> variants = updateVariants();
+
+    GalaxyParams params;
+    params.seed = kGoldenSeed;
+    for (const UpdateVariant &variant : variants) {
+        StarStore stars;
+        stars.resize(kGoldenPoints);
+        initGalaxy(stars, params);
+        auto step = variant.make();
+        for (int f = 0; f < kGoldenFrames; ++f) {
+            step(stars, params);
+        }
+        golden.check("update", variant.name, digestStars(stars));
+    }
+
+    printBenchHeader();
+    for (int size : options.sizes) {
+        for (const UpdateVariant &variant : variants) {
+            StarStore stars;
+            stars.resize(size);
+            initGalaxy(stars, params);
+            auto step = variant.make();
+            step(stars, params); // Calentar cachés y el estado de la variante
+            double seconds = bestSeconds(options.repeats, [] {}, [&] {
+                for (int k = 0; k < options.iterations; ++k) {
+                    step(stars, params);
+                }
+            });
+            printBenchRow("update", variant.name, size, seconds, options.iterations, kUpdateBytes);
+        }
+    }
+    return golden.finish();
+}
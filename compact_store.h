@@ -0,0 +1,295 @@
+/*
+* Nombre: compact_store.h
+* Autores:
+  - Andrés Montoya, 21552
+  - Fernanda Esquivel, 21542
+  - Francisco Castillo, 21562
+* Descripción: Estado compacto de la galaxia (6 bytes por estrella) en punto fijo de 16 bits,
+  para galaxias tan grandes que la actualización queda limitada por el ancho de banda de memoria.
+* Lenguaje: C++
+* Recursos: CLion
+* Historial:
+  - Creado el 17.10.2026
+  - Modificado el 17.10.2026 (la generación ya no da la vuelta a las 128 reapariciones)
+  - Modificado el 17.10.2026 (la generación completa solo se guarda para --compact-check)
+*/
+
+#ifndef PARALLEL_SCREENSAVER_COMPACT_STORE_H
+#define PARALLEL_SCREENSAVER_COMPACT_STORE_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+#include "galaxy.h"
+#include "parallel_backend.h"
+#include "simd_update.h"
+#include "star_store.h"
+#include "star_update.h"
+
+// Con u = 2 - r/R, g = q^t (q = 1 + s/R) y k = b/(q - 1), la fórmula cerrada de time_step.h es
+//     u(t) = A·g(t)        θ(t) = C + k·u(t)
+// donde A y C son constantes mientras la estrella no reaparece. Cada estrella guarda solo esas
+// dos constantes en 16 bits y el tiempo vive en un único factor g compartido, así que avanzar
+// la galaxia no escribe nada: basta comparar A con el umbral 2/g para encontrar las estrellas
+// que llegaron al centro. Cuando g llega a 2 se divide entre 2 y todos los niveles se duplican
+// (un corrimiento de bits, sin error), así g queda siempre en [1, 2).
+//
+// Por estrella:
+//   level  A en punto fijo: A = level / 32768
+//   phase  C en unidades de 2π/65536 (el desborde da la vuelta completa)
+//   meta   bits 0-7 índice de paleta (de 256 niveles), bit 8 tamaño de 2 píxeles,
+//          bits 9-15 los 7 bits bajos de la generación (reapariciones, para los sorteos)
+// Son 6 bytes frente a los 26 de StarStore, y la actualización solo lee level (2 bytes).
+// Los sorteos de respawnDraw dependen de la generación, así que con 7 bits cada estrella
+// repite sus sorteos cada 128 reapariciones (unas 5 horas) y la galaxia deja de coincidir con
+// la de punto flotante. Para comparar las dos (--compact-check), init con fullGeneration
+// guarda además
+//   epoch  el resto de la generación (generación >> 7); solo se toca al reaparecer
+// y con 23 bits coinciden durante 8 millones de reapariciones.
+class CompactGalaxy {
+public:
+    static const int kLevelOne = 32768;
+
+    void init(std::size_t count, const GalaxyParams &params, const ParallelPolicy &policy = ParallelPolicy(),
+              bool fullGeneration = false) {
+        params_ = params;
+        double rate = static_cast<double>(params.speed) / params.maxRadius;  // q - 1
+        logGrowth_ = std::log1p(rate);
+        rotationGain_ = params.baseRotationSpeed / rate;
+        growth_ = 1.0;
+        level_.resize(count);
+        phase_.resize(count);
+        meta_.resize(count);
+        epoch_.resize(fullGeneration ? count : 0);
+
+        int numPoints = static_cast<int>(count);
+        int numBlocks = (numPoints + kUpdateBlock - 1) / kUpdateBlock;
+        parallelFor(policy, 0, numBlocks, [&](int block) {
+            int end = std::min(numPoints, (block + 1) * kUpdateBlock);
+            for (int i = block * kUpdateBlock; i < end; ++i) {
+                float radius, angle, pointSize;
+                sampleStar(params_, i, radius, angle, pointSize);
+                std::uint16_t palette = spawnPaletteIndex(radius / params_.maxRadius);
+                encode(i, 2.0 - radius / params_.maxRadius, angle, palette, pointSize > 1.5f, 0, growth_);
+            }
+        });
+    }
+
+    // Avanza la galaxia ticks (que no tienen que ser enteros); las estrellas que llegan al
+    // centro reaparecen con la fórmula exacta, igual que en advanceGalaxy
+    void advance(double ticks, const ParallelPolicy &policy = ParallelPolicy()) {
+        if (ticks <= 0.0) {
+            return;
+        }
+        double growth = growth_ * std::exp(ticks * logGrowth_);
+        int shift = 0;
+        double rebased = growth;
+        while (rebased >= 2.0 && shift < 16) {
+            rebased *= 0.5;
+            ++shift;
+        }
+        // Con 16 corrimientos o más todas las estrellas reaparecieron
+        while (rebased >= 2.0) {
+            rebased *= 0.5;
+        }
+        // A·g >= 2  <=>  level >= 65536/g
+        double limit = 2.0 * kLevelOne / growth;
+        std::uint32_t threshold = limit > 65536.0 ? 65536u : static_cast<std::uint32_t>(std::ceil(limit));
+
+        int numPoints = static_cast<int>(count());
+        int numBlocks = (numPoints + kUpdateBlock - 1) / kUpdateBlock;
+        parallelFor(policy, 0, numBlocks, [&](int block) {
+            int end = std::min(numPoints, (block + 1) * kUpdateBlock);
+            std::uint16_t *level = level_.data();
+            if (shift > 0) {
+                // Cada unos miles de ticks: hay que reescribir todos los niveles
+                for (int i = block * kUpdateBlock; i < end; ++i) {
+                    if (level[i] >= threshold) {
+                        respawn(i, growth, rebased);
+                    } else {
+                        level[i] = static_cast<std::uint16_t>(level[i] << shift);
+                    }
+                }
+                return;
+            }
+            // En un tick reaparece una estrella de cada miles: se busca el máximo de cada
+            // tramo (un ciclo que se vectoriza) y solo se revisan uno por uno los que lo superan
+            for (int chunk = block * kUpdateBlock; chunk < end; chunk += kScanChunk) {
+                int last = std::min(end, chunk + kScanChunk);
+                std::uint16_t top = 0;
+#pragma omp simd reduction(max:top)
+                for (int i = chunk; i < last; ++i) {
+                    top = level[i] > top ? level[i] : top;
+                }
+                if (top < threshold) {
+                    continue;
+                }
+                for (int i = chunk; i < last; ++i) {
+                    if (level[i] >= threshold) {
+                        respawn(i, growth, rebased);
+                    }
+                }
+            }
+        });
+        growth_ = rebased;
+    }
+
+    std::size_t count() const {
+        return level_.size();
+    }
+
+    std::size_t bytesPerStar() const {
+        return (epoch_.empty() ? 3 : 4) * sizeof(std::uint16_t);
+    }
+
+    const GalaxyParams &params() const {
+        return params_;
+    }
+
+    // Constantes para decodificar muchas estrellas seguidas (ver decode)
+    struct Decoder {
+        float levelScale;     // g / 32768
+        float phaseScale;     // 2π / 65536
+        float rotationGain;   // k
+        float maxRadius, centerX, centerY;
+    };
+
+    Decoder decoder() const {
+        Decoder d;
+        d.levelScale = static_cast<float>(growth_ / kLevelOne);
+        d.phaseScale = static_cast<float>(2.0 * kPi / 65536.0);
+        d.rotationGain = static_cast<float>(rotationGain_);
+        d.maxRadius = params_.maxRadius;
+        d.centerX = params_.centerX;
+        d.centerY = params_.centerY;
+        return d;
+    }
+
+    // Posición, radio, tamaño e índice de paleta (de 1024 niveles) de la estrella i
+    void decode(const Decoder &d, std::size_t i, float &x, float &y, float &radius, float &pointSize,
+                std::uint16_t &palette) const {
+        float u = level_[i] * d.levelScale;
+        float angle = phase_[i] * d.phaseScale + d.rotationGain * u;
+        radius = d.maxRadius * (2.0f - u);
+        x = d.centerX + radius * std::cos(angle);
+        y = d.centerY + radius * std::sin(angle);
+        std::uint16_t meta = meta_[i];
+        pointSize = (meta & 0x100) ? 2.0f : 1.0f;
+        palette = static_cast<std::uint16_t>((meta & 0xFF) * (kPaletteLevels - 1) / 255);
+    }
+
+    // Decodifica las estrellas [begin, end) en arreglos, con el seno y coseno vectoriales de
+    // simd_update.h; para el dibujo de muchas estrellas seguidas
+    void decodeBlock(const Decoder &d, int begin, int end, float *x, float *y, float *radius, float *pointSize,
+                     std::uint16_t *palette) const {
+        int i = begin;
+#ifdef GALAXY_HAS_X86_SIMD
+        for (; i + 4 <= end; i += 4) {
+            decodeSSE2(d, i, x + (i - begin), y + (i - begin), radius + (i - begin));
+        }
+#endif
+        for (; i < end; ++i) {
+            float size;
+            std::uint16_t index;
+            decode(d, i, x[i - begin], y[i - begin], radius[i - begin], size, index);
+        }
+        for (i = begin; i < end; ++i) {
+            std::uint16_t meta = meta_[i];
+            pointSize[i - begin] = (meta & 0x100) ? 2.0f : 1.0f;
+            palette[i - begin] = static_cast<std::uint16_t>((meta & 0xFF) * (kPaletteLevels - 1) / 255);
+        }
+    }
+
+    // Reapariciones de la estrella i (módulo 2^23 con fullGeneration, si no módulo 128)
+    std::uint32_t generation(std::size_t i) const {
+        std::uint32_t low = meta_[i] >> 9;
+        return epoch_.empty() ? low : static_cast<std::uint32_t>(epoch_[i]) << 7 | low;
+    }
+
+    // Cota del error de posición (en píxeles) frente al estado en punto flotante:
+    //   |Δu| <= ½·g/32768 < 1/32768 (g < 2),   |Δr| = R·|Δu|
+    //   |Δθ| <= π/65536 (fase) + k·|Δu| + el redondeo de float al decodificar ángulos hasta 2π + 2k
+    // y como r <= 1.1R, |Δpos| <= |Δr| + 1.1R·|Δθ|
+    double errorBound() const {
+        double du = 1.0 / kLevelOne;
+        double dTheta = kPi / 65536.0 + rotationGain_ * du + (2.0 * kPi + 2.0 * rotationGain_) * std::ldexp(1.0, -23);
+        return params_.maxRadius * du + 1.1 * params_.maxRadius * dTheta;
+    }
+
+private:
+    static constexpr double kPi = 3.14159265358979323846;
+    static const int kScanChunk = 256;
+
+#ifdef GALAXY_HAS_X86_SIMD
+    __attribute__((target("sse2")))
+    void decodeSSE2(const Decoder &d, int i, float *x, float *y, float *radius) const {
+        __m128i level = _mm_unpacklo_epi16(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(&level_[i])),
+                                           _mm_setzero_si128());
+        __m128i phase = _mm_unpacklo_epi16(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(&phase_[i])),
+                                           _mm_setzero_si128());
+        __m128 u = _mm_mul_ps(_mm_cvtepi32_ps(level), _mm_set1_ps(d.levelScale));
+        __m128 angle = _mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(phase), _mm_set1_ps(d.phaseScale)),
+                                  _mm_mul_ps(_mm_set1_ps(d.rotationGain), u));
+        __m128 r = _mm_mul_ps(_mm_set1_ps(d.maxRadius), _mm_sub_ps(_mm_set1_ps(2.0f), u));
+        __m128 s, c;
+        sincosSSE2(angle, s, c);
+        _mm_storeu_ps(radius, r);
+        _mm_storeu_ps(x, _mm_add_ps(_mm_set1_ps(d.centerX), _mm_mul_ps(r, c)));
+        _mm_storeu_ps(y, _mm_add_ps(_mm_set1_ps(d.centerY), _mm_mul_ps(r, s)));
+    }
+#endif
+
+    void encode(int i, double u, double theta, std::uint16_t palette, bool large, std::uint32_t generation,
+                double growth) {
+        long level = std::lround(u / growth * kLevelOne);
+        level = level < 0 ? 0 : (level > 65535 ? 65535 : level);
+        // La fase se calcula con el nivel ya redondeado: al codificar el ángulo queda exacto
+        double stored = static_cast<double>(level) / kLevelOne * growth;
+        double phase = (theta - rotationGain_ * stored) / (2.0 * kPi) * 65536.0;
+        level_[i] = static_cast<std::uint16_t>(level);
+        phase_[i] = static_cast<std::uint16_t>(static_cast<std::int64_t>(std::llround(phase)) & 0xFFFF);
+        meta_[i] = static_cast<std::uint16_t>((palette * 255 + (kPaletteLevels - 1) / 2) / (kPaletteLevels - 1) |
+                                              (large ? 0x100 : 0) | (generation & 0x7F) << 9);
+        if (!epoch_.empty()) {
+            epoch_[i] = static_cast<std::uint16_t>(generation >> 7);
+        }
+    }
+
+    // Igual que advanceStarExact: la estrella llegó al centro hace ln(u/2)/ln(q) ticks
+    void respawn(int i, double growth, double rebased) {
+        double u = static_cast<double>(level_[i]) / kLevelOne * growth;
+        double theta = phase_[i] * (2.0 * kPi / 65536.0) + rotationGain_ * 2.0;  // Ángulo al llegar
+        std::uint32_t generation = this->generation(i);
+        bool large = (meta_[i] & 0x100) != 0;
+        std::uint16_t palette = 0;
+        for (;;) {
+            double remaining = std::log(u / 2.0) / logGrowth_;
+            // Mismo módulo que advanceStarExact, para que los sorteos partan del mismo ángulo
+            float angle = static_cast<float>(std::fmod(theta, static_cast<double>(kTwoPi)));
+            float radius;
+            generation = epoch_.empty() ? (generation + 1) & 0x7F : generation + 1;
+            respawnDraw(params_, i, generation, angle, radius);
+            palette = respawnPaletteIndex(radius / params_.maxRadius);
+            double start = 2.0 - radius / params_.maxRadius;
+            u = start * std::exp(remaining * logGrowth_);
+            if (u < 2.0) {
+                theta = angle + rotationGain_ * (u - start);
+                break;
+            }
+            theta = angle + rotationGain_ * (2.0 - start);
+        }
+        encode(i, u, theta, palette, large, generation, rebased);
+    }
+
+    GalaxyParams params_;
+    double logGrowth_ = 0.0;     // ln(q)
+    double rotationGain_ = 0.0;  // k = b/(q - 1)
+    double growth_ = 1.0;        // g, siempre en [1, 2)
+    StarArray<std::uint16_t> level_;
+    StarArray<std::uint16_t> phase_;
+    StarArray<std::uint16_t> meta_;
+    StarArray<std::uint16_t> epoch_;  // Vacío salvo con fullGeneration
+};
+
+#endif //PARALLEL_SCREENSAVER_COMPACT_STORE_H
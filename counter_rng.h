@@ -0,0 +1,50 @@
+/*
+* Nombre: counter_rng.h
+* Autores:
+  - Andrés Montoya, 21552
+  - Fernanda Esquivel, 21542
+  - Francisco Castillo, 21562
+* Descripción: Números aleatorios basados en contador (estilo SplitMix), seguros entre hilos y reproducibles.
+* Lenguaje: C++
+* Recursos: CLion
+* Historial:
+  - Creado el 17.10.2026
+*/
+
+#ifndef PARALLEL_SCREENSAVER_COUNTER_RNG_H
+#define PARALLEL_SCREENSAVER_COUNTER_RNG_H
+
+#include <cstdint>
+
+// Flujos independientes de números aleatorios, uno por uso
+enum RandomStream : std::uint32_t {
+    kStreamInit = 1,      // Generación inicial de cada estrella
+    kStreamRespawn = 2,   // Variación al reaparecer en el borde
+    kStreamExtraStar = 3  // Posición de las estrellas adicionales
+};
+
+// Finalizador de SplitMix64: mezcla los bits de forma que entradas consecutivas
+// producen salidas sin correlación aparente
+inline std::uint64_t mixBits(std::uint64_t z) {
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+// El valor depende solo de la semilla, el flujo, el índice (estrella o estrella adicional),
+// un contador (p. ej. cuántas veces reapareció la estrella) y el número de sorteo. No hay
+// estado compartido, así que el resultado es el mismo con cualquier cantidad de hilos.
+inline std::uint64_t randomBits(std::uint64_t seed, std::uint32_t stream, std::uint32_t index,
+                                std::uint32_t counter, std::uint32_t draw) {
+    std::uint64_t key = mixBits(seed + 0x9e3779b97f4a7c15ULL * stream);
+    key = mixBits(key ^ ((static_cast<std::uint64_t>(index) << 32) | counter));
+    return mixBits(key + 0x9e3779b97f4a7c15ULL * (draw + 1));
+}
+
+// Número uniforme en [0, 1) con 24 bits de precisión
+inline float randomUniform(std::uint64_t seed, std::uint32_t stream, std::uint32_t index,
+                           std::uint32_t counter, std::uint32_t draw) {
+    return static_cast<float>(randomBits(seed, stream, index, counter, draw) >> 40) * (1.0f / 16777216.0f);
+}
+
+#endif //PARALLEL_SCREENSAVER_COUNTER_RNG_H
@@ -0,0 +1,258 @@
+/*
+* Nombre: density.h
+* Autores:
+  - Andrés Montoya, 21552
+  - Fernanda Esquivel, 21542
+  - Francisco Castillo, 21562
+* Descripción: Dibujo por acumulación de densidad para galaxias de millones de estrellas.
+* Lenguaje: C++
+* Recursos: CLion
+* Historial:
+  - Creado el 17.10.2026
+  - Modificado el 17.10.2026 (dibujo desde el estado compacto)
+  - Modificado el 17.10.2026 (acumulación por mosaicos en lugar de un búfer completo por hilo)
+*/
+
+#ifndef PARALLEL_SCREENSAVER_DENSITY_H
+#define PARALLEL_SCREENSAVER_DENSITY_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+#include <omp.h>
+
+#include "compact_store.h"
+#include "extra_stars.h"
+#include "palette.h"
+#include "software_raster.h"
+#include "star_store.h"
+
+// Con millones de estrellas casi todas caen sobre píxeles ya ocupados, así que en lugar de
+// dibujar cada una se suma su color en un búfer de punto flotante y al final se comprime
+// el resultado a 8 bits. Como en TiledRasterizer, las estrellas se reparten primero en
+// mosaicos de 64x64 y después cada hilo acumula mosaicos completos: no hay atómicos ni un
+// búfer por hilo que combinar, así que la memoria no crece con la cantidad de núcleos. Cada
+// píxel suma sus estrellas en el orden del arreglo y la imagen no depende de los hilos.
+class DensityRenderer {
+public:
+    explicit DensityRenderer(int width = 800, int height = 800)
+        : width_(width), height_(height) {}
+
+    // Ganancia del mapeo de tonos; 0 la ajusta según la cantidad de estrellas
+    void setExposure(float exposure) {
+        exposure_ = exposure;
+    }
+
+    void render(const StarStore &stars, const Palette &palette, Framebuffer &frame) {
+        accumulate(static_cast<int>(stars.count()), palette, frame, [&](int begin, int end, StarBatch &batch) {
+            for (int i = begin; i < end; ++i) {
+                batch.x[i - begin] = stars.x[i];
+                batch.y[i - begin] = stars.y[i];
+                batch.size[i - begin] = stars.pointSize[i];
+                batch.color[i - begin] = palette.indexOf(stars, i);
+            }
+        });
+    }
+
+    // Mismo dibujo a partir del estado compacto, decodificando las estrellas por tramos
+    void render(const CompactGalaxy &galaxy, const Palette &palette, Framebuffer &frame) {
+        CompactGalaxy::Decoder decoder = galaxy.decoder();
+        float invMaxRadius = 1.0f / decoder.maxRadius;
+        accumulate(static_cast<int>(galaxy.count()), palette, frame, [&](int begin, int end, StarBatch &batch) {
+            float radius[kBatch];
+            std::uint16_t index[kBatch];
+            galaxy.decodeBlock(decoder, begin, end, batch.x, batch.y, radius, batch.size, index);
+            for (int k = 0; k < end - begin; ++k) {
+                batch.color[k] = palette.colorFollowsRadius() ? paletteIndex(radius[k] * invMaxRadius) : index[k];
+            }
+        });
+    }
+
+    // Mezcla las estrellas adicionales sobre la imagen ya mapeada (son pocas: en serie)
+    void drawExtraStars(const ExtraStarPool &extraStars, Framebuffer &frame) const {
+        for (std::size_t k = 0; k < extraStars.count(); ++k) {
+            blendExtraStar(extraStars, k, 0, 0, frame.width, frame.height, frame);
+        }
+    }
+
+private:
+    // Tramo de estrellas ya listas para acumular
+    static const int kBatch = 256;
+    struct StarBatch {
+        float x[kBatch];
+        float y[kBatch];
+        float size[kBatch];
+        std::uint16_t color[kBatch];
+    };
+
+    // Lado de los mosaicos: el píxel dentro del mosaico cabe en 12 bits
+    static const int kTileBits = 6;
+    static const int kTile = 1 << kTileBits;
+    // Estrellas que se reparten de una vez; acota la memoria de los búferes intermedios
+    static const int kChunk = 1 << 21;
+    static const std::uint32_t kHidden = 0xFFFFFFFFu;
+
+    // Aporte de una estrella: mosaico << 12 | píxel dentro del mosaico (kHidden si no se ve)
+    struct Splat {
+        std::uint32_t key;
+        std::uint16_t color;
+        std::uint16_t size;
+    };
+
+    // fill(begin, end, batch) llena la posición, el tamaño y el color de las estrellas
+    // [begin, end), a lo más kBatch
+    template <typename Fill>
+    void accumulate(int numPoints, const Palette &palette, Framebuffer &frame, Fill fill) {
+        if (frame.width != width_ || frame.height != height_) {
+            frame.resize(width_, height_);
+        }
+        int tilesX = (width_ + kTile - 1) / kTile;
+        int tilesY = (height_ + kTile - 1) / kTile;
+        int tiles = tilesX * tilesY;
+        int parts = omp_get_max_threads();
+        std::size_t channels = static_cast<std::size_t>(width_) * height_ * 3;
+        if (accum_.size() != channels) {
+            accum_.assign(channels, 0.0f);
+        }
+        std::size_t chunkStars = static_cast<std::size_t>(std::min(numPoints, kChunk));
+        if (splats_.size() < chunkStars) {
+            splats_.resize(chunkStars);
+            binned_.resize(chunkStars);
+        }
+        counts_.resize(static_cast<std::size_t>(parts) * tiles);
+        tileStart_.resize(tiles + 1);
+
+#pragma omp parallel num_threads(parts)
+        {
+            StarBatch batch;
+            for (int chunk = 0; chunk < numPoints; chunk += kChunk) {
+                int chunkEnd = std::min(numPoints, chunk + kChunk);
+                auto partBegin = [chunk, chunkEnd, parts](int part) {
+                    return chunk + static_cast<int>(static_cast<long long>(chunkEnd - chunk) * part / parts);
+                };
+
+                // Cada tramo contiguo calcula el píxel de sus estrellas (el de su centro) y
+                // cuenta cuántas caen en cada mosaico
+#pragma omp for schedule(static)
+                for (int part = 0; part < parts; ++part) {
+                    int *count = &counts_[static_cast<std::size_t>(part) * tiles];
+                    std::fill(count, count + tiles, 0);
+                    for (int begin = partBegin(part), last = partBegin(part + 1); begin < last; begin += kBatch) {
+                        int n = std::min(kBatch, last - begin);
+                        fill(begin, begin + n, batch);
+                        Splat *out = &splats_[begin - chunk];
+                        for (int k = 0; k < n; ++k) {
+                            float r = batch.size[k];
+                            int px = static_cast<int>(std::floor(batch.x[k] + r));
+                            int py = static_cast<int>(std::floor(batch.y[k] + r));
+                            if (px < 0 || py < 0 || px >= width_ || py >= height_) {
+                                out[k].key = kHidden;
+                                continue;
+                            }
+                            int tile = (py >> kTileBits) * tilesX + (px >> kTileBits);
+                            out[k].key = static_cast<std::uint32_t>(tile) << (2 * kTileBits) |
+                                         static_cast<std::uint32_t>((py & (kTile - 1)) << kTileBits | (px & (kTile - 1)));
+                            out[k].color = batch.color[k];
+                            out[k].size = static_cast<std::uint16_t>(r);
+                            ++count[tile];
+                        }
+                    }
+                }
+
+                // Prefijo en orden (mosaico, tramo): dentro de cada mosaico las estrellas
+                // quedan en el orden del arreglo
+#pragma omp single
+                {
+                    int offset = 0;
+                    for (int tile = 0; tile < tiles; ++tile) {
+                        tileStart_[tile] = offset;
+                        for (int part = 0; part < parts; ++part) {
+                            int &slot = counts_[static_cast<std::size_t>(part) * tiles + tile];
+                            int c = slot;
+                            slot = offset;
+                            offset += c;
+                        }
+                    }
+                    tileStart_[tiles] = offset;
+                }
+
+#pragma omp for schedule(static)
+                for (int part = 0; part < parts; ++part) {
+                    int *next = &counts_[static_cast<std::size_t>(part) * tiles];
+                    for (int i = partBegin(part), last = partBegin(part + 1); i < last; ++i) {
+                        const Splat &splat = splats_[i - chunk];
+                        if (splat.key != kHidden) {
+                            binned_[next[splat.key >> (2 * kTileBits)]++] = splat;
+                        }
+                    }
+                }
+
+                // Cada mosaico lo acumula un solo hilo. El peso de cada estrella es su área
+                // relativa (1 o 4) para conservar el brillo de los puntos grandes.
+#pragma omp for schedule(dynamic)
+                for (int tile = 0; tile < tiles; ++tile) {
+                    int x0 = (tile % tilesX) * kTile;
+                    int y0 = (tile / tilesX) * kTile;
+                    for (int b = tileStart_[tile]; b < tileStart_[tile + 1]; ++b) {
+                        const Splat &splat = binned_[b];
+                        int local = static_cast<int>(splat.key & ((1u << (2 * kTileBits)) - 1));
+                        int px = x0 + (local & (kTile - 1));
+                        int py = y0 + (local >> kTileBits);
+                        const PaletteColor &color = palette[splat.color];
+                        float weight = splat.size * splat.size * (1.0f / 255.0f);
+                        float *p = &accum_[(static_cast<std::size_t>(py) * width_ + px) * 3];
+                        p[0] += color.r * weight;
+                        p[1] += color.g * weight;
+                        p[2] += color.b * weight;
+                    }
+                }
+            }
+        }
+
+        // Mapear los tonos: 1 - e^(-k·x) deja igual de visibles una estrella aislada y el
+        // núcleo saturado. El búfer se limpia en la misma pasada. La curva se lee de una
+        // tabla para no calcular una exponencial por canal.
+        float exposure = exposure_ > 0.0f ? exposure_ : autoExposure(numPoints);
+        float scale = exposure * (kToneLevels / kToneRange);
+        long long total = static_cast<long long>(channels);
+#pragma omp parallel for schedule(static)
+        for (long long c = 0; c < total; ++c) {
+            float level = accum_[c] * scale;
+            accum_[c] = 0.0f;
+            frame.pixels[c] = toneCurve()[level < kToneLevels - 1 ? static_cast<int>(level) : kToneLevels - 1];
+        }
+    }
+
+    // 1 - e^(-x) para x en [0, 16); más allá la curva ya vale 255
+    static const int kToneLevels = 4096;
+    static constexpr float kToneRange = 16.0f;
+
+    static const std::uint8_t *toneCurve() {
+        static const std::vector<std::uint8_t> curve = [] {
+            std::vector<std::uint8_t> values(kToneLevels);
+            for (int i = 0; i < kToneLevels; ++i) {
+                float x = (i + 0.5f) * (kToneRange / kToneLevels);
+                values[i] = static_cast<std::uint8_t>(255.0f * (1.0f - std::exp(-x)) + 0.5f);
+            }
+            return values;
+        }();
+        return curve.data();
+    }
+
+    // Hasta 100 000 estrellas una estrella aislada queda casi con su color original;
+    // con más, la ganancia baja en proporción para que la densidad media no se sature
+    static float autoExposure(int numPoints) {
+        return 1.5f * 100000.0f / static_cast<float>(std::max(numPoints, 100000));
+    }
+
+    int width_, height_;
+    float exposure_ = 0.0f;
+    std::vector<float> accum_;    // Búfer RGB de punto flotante de todo el frame
+    std::vector<Splat> splats_;   // Aporte de cada estrella del tramo, en el orden del arreglo
+    std::vector<Splat> binned_;   // Los mismos aportes agrupados por mosaico
+    std::vector<int> counts_;     // Conteo (y luego posición de escritura) por tramo y mosaico
+    std::vector<int> tileStart_;  // Inicio de cada mosaico dentro de binned_
+};
+
+#endif //PARALLEL_SCREENSAVER_DENSITY_H
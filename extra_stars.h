@@ -0,0 +1,186 @@
+/*
+* Nombre: extra_stars.h
+* Autores:
+  - Andrés Montoya, 21552
+  - Fernanda Esquivel, 21542
+  - Francisco Castillo, 21562
+* Descripción: Estrellas adicionales que aparecen y se desvanecen, en un búfer circular sin reservas de memoria.
+* Lenguaje: C++
+* Recursos: CLion
+* Historial:
+  - Creado el 17.10.2026
+*/
+
+#ifndef PARALLEL_SCREENSAVER_EXTRA_STARS_H
+#define PARALLEL_SCREENSAVER_EXTRA_STARS_H
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "counter_rng.h"
+#include "star_update.h"
+
+// Forma de estrella de 5 puntas compartida por todas las estrellas adicionales: 10 vértices
+// alternando el radio exterior y el interior, desplazados como el origen (radio, radio)
+// que usaba el sf::ConvexShape original.
+struct StarGeometry {
+    static const int kVertices = 10;
+    float x[kVertices];
+    float y[kVertices];
+    float centerX;  // Centro del abanico de triángulos (centro de la caja, como en SFML)
+    float centerY;
+    float minX, minY, maxX, maxY; // Caja que contiene la estrella
+
+    StarGeometry(float outerRadius, int points) {
+        minX = maxX = minY = maxY = 0;
+        for (int i = 0; i < kVertices; i++) {
+            float angle = i * 3.14159f / points;
+            float r = (i % 2 == 0) ? outerRadius : outerRadius / 2;
+            x[i] = std::cos(angle) * r - outerRadius;
+            y[i] = std::sin(angle) * r - outerRadius;
+            minX = i == 0 || x[i] < minX ? x[i] : minX;
+            maxX = i == 0 || x[i] > maxX ? x[i] : maxX;
+            minY = i == 0 || y[i] < minY ? y[i] : minY;
+            maxY = i == 0 || y[i] > maxY ? y[i] : maxY;
+        }
+        centerX = (minX + maxX) / 2;
+        centerY = (minY + maxY) / 2;
+    }
+
+    // Indica si el punto (relativo a la posición de la estrella) cae dentro del polígono
+    // (regla par-impar, válida aunque la estrella no sea convexa)
+    bool contains(float px, float py) const {
+        bool inside = false;
+        for (int i = 0, j = kVertices - 1; i < kVertices; j = i++) {
+            if ((y[i] > py) != (y[j] > py) &&
+                px < (x[j] - x[i]) * (py - y[i]) / (y[j] - y[i]) + x[i]) {
+                inside = !inside;
+            }
+        }
+        return inside;
+    }
+};
+
+inline const StarGeometry &extraStarGeometry() {
+    static const StarGeometry geometry(6.0f, 5); // Una estrella más grande que los puntos
+    return geometry;
+}
+
+// Todas las estrellas viven lo mismo, así que expiran en el mismo orden en que nacen:
+// un búfer circular permite crear y reciclar cada una en O(1) sin mover las demás.
+class ExtraStarPool {
+public:
+    explicit ExtraStarPool(float spawnRate = 10.0f, float lifetime = 1.5f)
+        : lifetime_(lifetime) {
+        setSpawnRate(spawnRate);
+    }
+
+    // Estrellas por segundo. Solo cambia la capacidad cuando cambia la tasa, nunca por frame.
+    void setSpawnRate(float rate) {
+        spawnRate_ = rate > 0.0f ? rate : 0.0f;
+        std::size_t capacity = static_cast<std::size_t>(std::ceil(spawnRate_ * lifetime_)) + 2;
+        if (capacity == x_.size()) {
+            return;
+        }
+
+        // Copiar las estrellas vivas en orden al nuevo arreglo (de la más vieja a la más nueva)
+        std::size_t keep = size_ < capacity ? size_ : capacity;
+        std::size_t skip = size_ - keep;
+        std::vector<float> x(capacity), y(capacity), remaining(capacity);
+        for (std::size_t k = 0; k < keep; ++k) {
+            std::size_t slot = slotOf(skip + k);
+            x[k] = x_[slot];
+            y[k] = y_[slot];
+            remaining[k] = remaining_[slot];
+        }
+        x_.swap(x);
+        y_.swap(y);
+        remaining_.swap(remaining);
+        head_ = 0;
+        size_ = keep;
+    }
+
+    float spawnRate() const {
+        return spawnRate_;
+    }
+
+    // Desvanece, recicla y genera estrellas para un frame de dt segundos
+    void update(float dt, const GalaxyParams &params) {
+        // Desvanecer todas de una vez
+        for (std::size_t k = 0; k < size_; ++k) {
+            remaining_[slotOf(k)] -= dt;
+        }
+
+        // Las expiradas están siempre al principio
+        while (size_ > 0 && remaining_[head_] <= 0.0f) {
+            head_ = (head_ + 1) % x_.size();
+            --size_;
+        }
+
+        spawnAccumulator_ += dt * spawnRate_;
+        while (spawnAccumulator_ >= 1.0f) {
+            spawnAccumulator_ -= 1.0f;
+            spawn(params);
+        }
+    }
+
+    std::size_t count() const {
+        return size_;
+    }
+
+    // Acceso a la k-ésima estrella viva (0 = la más vieja)
+    float x(std::size_t k) const {
+        return x_[slotOf(k)];
+    }
+
+    float y(std::size_t k) const {
+        return y_[slotOf(k)];
+    }
+
+    // Opacidad proporcional al tiempo de vida restante
+    std::uint8_t alpha(std::size_t k) const {
+        float value = 255 * (remaining_[slotOf(k)] / lifetime_);
+        return static_cast<std::uint8_t>(value < 0.0f ? 0.0f : (value > 255.0f ? 255.0f : value));
+    }
+
+private:
+    std::size_t slotOf(std::size_t k) const {
+        return (head_ + k) % x_.size();
+    }
+
+    void spawn(const GalaxyParams &params) {
+        if (x_.empty()) {
+            return;
+        }
+        // Si el búfer está lleno se reutiliza la estrella más vieja
+        if (size_ == x_.size()) {
+            head_ = (head_ + 1) % x_.size();
+            --size_;
+        }
+
+        float starRadius = randomUniform(params.seed, kStreamExtraStar, sequence_, 0, 0) * params.maxRadius;
+        float starAngle = randomUniform(params.seed, kStreamExtraStar, sequence_, 0, 1) * 2 * 3.14159f;
+        ++sequence_;
+
+        std::size_t slot = slotOf(size_);
+        x_[slot] = params.centerX + starRadius * std::cos(starAngle);
+        y_[slot] = params.centerY + starRadius * std::sin(starAngle);
+        remaining_[slot] = lifetime_; // Tiempo de vida de la estrella en segundos
+        ++size_;
+    }
+
+    float lifetime_;
+    float spawnRate_ = 0.0f;
+    float spawnAccumulator_ = 0.0f;
+    std::uint32_t sequence_ = 0;   // Número de estrellas creadas, para los números aleatorios
+
+    std::vector<float> x_;
+    std::vector<float> y_;
+    std::vector<float> remaining_; // Tiempo de vida restante
+    std::size_t head_ = 0;         // Ranura de la estrella más vieja
+    std::size_t size_ = 0;         // Estrellas vivas
+};
+
+#endif //PARALLEL_SCREENSAVER_EXTRA_STARS_H
@@ -0,0 +1,202 @@
+/*
+* Nombre: frame_pipeline.h
+* Autores:
+  - Andrés Montoya, 21552
+  - Fernanda Esquivel, 21542
+  - Francisco Castillo, 21562
+* Descripción: Simulación y dibujo en paralelo: un hilo calcula el frame N+1 mientras se dibuja el frame N.
+* Lenguaje: C++
+* Recursos: CLion
+* Historial:
+  - Creado el 17.10.2026
+  - Modificado el 17.10.2026 (avance por tiempo)
+  - Modificado el 17.10.2026 (política paralela intercambiable)
+  - Modificado el 17.10.2026 (paso de simulación intercambiable)
+  - Modificado el 17.10.2026 (copia en paralelo y el primer frame ya avanzado, como el ciclo secuencial)
+*/
+
+#ifndef PARALLEL_SCREENSAVER_FRAME_PIPELINE_H
+#define PARALLEL_SCREENSAVER_FRAME_PIPELINE_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+#include "parallel_backend.h"
+#include "star_store.h"
+
+// Tres búferes: el que escribe la simulación, el que lee el dibujo y uno intermedio.
+// Publicar y tomar un frame es un solo intercambio atómico, sin bloqueos; ninguno de los
+// dos hilos toca nunca el búfer que está usando el otro.
+template <typename T>
+class TripleBuffer {
+public:
+    T &back() {
+        return buffers_[back_];
+    }
+
+    const T &front() const {
+        return buffers_[front_];
+    }
+
+    // Entrega el búfer de escritura y toma el intermedio para el siguiente frame
+    void publish() {
+        unsigned previous = middle_.exchange(back_ | kFresh, std::memory_order_acq_rel);
+        back_ = previous & kIndexMask;
+    }
+
+    // Toma el último frame publicado; devuelve falso si no hay uno nuevo
+    bool acquire() {
+        if ((middle_.load(std::memory_order_acquire) & kFresh) == 0) {
+            return false;
+        }
+        unsigned previous = middle_.exchange(front_, std::memory_order_acq_rel);
+        front_ = previous & kIndexMask;
+        return true;
+    }
+
+private:
+    static const unsigned kIndexMask = 3;
+    static const unsigned kFresh = 4;
+
+    T buffers_[3];
+    unsigned back_ = 0;
+    unsigned front_ = 2;
+    std::atomic<unsigned> middle_{1};
+};
+
+// Avanza el estado de la galaxia los ticks indicados (0 = un tick del ciclo original)
+typedef std::function<void(StarStore &, double)> SimulationStep;
+
+template <typename T>
+inline void copyColumnRange(const StarColumn<T> &from, StarColumn<T> &to, std::size_t begin, std::size_t end) {
+    if (end > begin) {
+        std::memcpy(to.data() + begin, from.data() + begin, (end - begin) * sizeof(T));
+    }
+}
+
+// Copia el estado por bloques repartidos entre los hilos. Con --large son 26 bytes por estrella
+// en cada frame y una copia en serie costaba más que la actualización en paralelo.
+inline void copyStars(const StarStore &from, StarStore &to, const ParallelPolicy &policy) {
+    const std::size_t kCopyBlock = 1 << 16;
+    std::size_t n = from.count();
+    if (to.count() != n) {
+        to.resize(n);
+    }
+    if (to.id.size() != from.id.size()) {
+        to.id.resize(from.id.size());
+    }
+    bool ids = from.id.size() != 0;
+    int blocks = static_cast<int>((n + kCopyBlock - 1) / kCopyBlock);
+    parallelFor(policy, 0, blocks, [&](int block) {
+        std::size_t begin = block * kCopyBlock;
+        std::size_t end = std::min(n, begin + kCopyBlock);
+        copyColumnRange(from.radius, to.radius, begin, end);
+        copyColumnRange(from.angle, to.angle, begin, end);
+        copyColumnRange(from.pointSize, to.pointSize, begin, end);
+        copyColumnRange(from.palette, to.palette, begin, end);
+        copyColumnRange(from.generation, to.generation, begin, end);
+        copyColumnRange(from.x, to.x, begin, end);
+        copyColumnRange(from.y, to.y, begin, end);
+        if (ids) {
+            copyColumnRange(from.id, to.id, begin, end);
+        }
+    });
+}
+
+// Hilo de simulación con un frame de adelanto. La simulación avanza un paso por cada frame
+// que se dibuja, pero el paso N+1 se calcula mientras el hilo principal dibuja el N, así que
+// el tiempo por frame es el máximo de las dos fases. Como en el ciclo secuencial, que avanza
+// antes de dibujar, el primer frame ya es el estado tras un paso: la secuencia de frames es
+// la misma. Por defecto cada paso es un tick; con setStepTicks cada paso avanza ese tiempo.
+//
+// El paso trabaja sobre el estado en su lugar, así que cada frame se copia al búfer que se
+// publica; la copia se reparte entre los hilos con la misma política que la actualización.
+class SimulationPipeline {
+public:
+    SimulationPipeline(const StarStore &initial, SimulationStep step, const ParallelPolicy &policy = ParallelPolicy())
+        : state_(initial), step_(step), policy_(policy) {
+        thread_ = std::thread(&SimulationPipeline::run, this);
+    }
+
+    ~SimulationPipeline() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        wake_.notify_all();
+        thread_.join();
+    }
+
+    // Espera el siguiente frame simulado y lo devuelve. El frame queda válido hasta la
+    // próxima llamada; al tomarlo, la simulación empieza a calcular el siguiente.
+    const StarStore &acquire() {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            wake_.wait(lock, [this] { return produced_ > consumed_; });
+            buffers_.acquire();
+            ++consumed_;
+        }
+        wake_.notify_all();
+        return buffers_.front();
+    }
+
+    // Ticks que avanzará el próximo paso que empiece a calcularse (0 = un tick del ciclo original)
+    void setStepTicks(double ticks) {
+        stepTicks_.store(ticks, std::memory_order_relaxed);
+    }
+
+    // Segundos acumulados en la actualización de las estrellas (solo el hilo de simulación)
+    double updateSeconds() const {
+        return updateNanoseconds_.load() * 1e-9;
+    }
+
+private:
+    void run() {
+        for (;;) {
+            {
+                // Un solo frame de adelanto: esperar a que el anterior se haya tomado
+                std::unique_lock<std::mutex> lock(mutex_);
+                wake_.wait(lock, [this] { return stop_ || produced_ == consumed_; });
+                if (stop_) {
+                    return;
+                }
+            }
+
+            auto start = std::chrono::steady_clock::now();
+            step_(state_, stepTicks_.load(std::memory_order_relaxed));
+            copyStars(state_, buffers_.back(), policy_);
+            updateNanoseconds_ += std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - start).count();
+
+            buffers_.publish();
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                ++produced_;
+            }
+            wake_.notify_all();
+        }
+    }
+
+    StarStore state_;                  // Estado que avanza la simulación
+    TripleBuffer<StarStore> buffers_;  // Copias publicadas para dibujar
+    SimulationStep step_;
+    ParallelPolicy policy_;
+
+    std::mutex mutex_;                 // Solo protege los contadores para poder esperar
+    std::condition_variable wake_;
+    std::uint64_t produced_ = 0;
+    std::uint64_t consumed_ = 0;
+    bool stop_ = false;
+    std::atomic<std::int64_t> updateNanoseconds_{0};
+    std::atomic<double> stepTicks_{0.0};
+    std::thread thread_;
+};
+
+#endif //PARALLEL_SCREENSAVER_FRAME_PIPELINE_H
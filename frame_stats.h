@@ -0,0 +1,245 @@
+/*
+* Nombre: frame_stats.h
+* Autores:
+  - Andrés Montoya, 21552
+  - Fernanda Esquivel, 21542
+  - Francisco Castillo, 21562
+* Descripción: Histogramas de latencia de memoria fija por fase del frame (p50/p90/p99/max), exportables a CSV o JSON.
+* Lenguaje: C++
+* Recursos: CLion
+* Historial:
+  - Creado el 17.10.2026
+  - Modificado el 17.10.2026 (lap devuelve el tiempo medido)
+  - Modificado el 17.10.2026 (fase de espera del límite de FPS)
+*/
+
+#ifndef PARALLEL_SCREENSAVER_FRAME_STATS_H
+#define PARALLEL_SCREENSAVER_FRAME_STATS_H
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <ostream>
+#include <string>
+
+// Histograma logarítmico-lineal en nanosegundos: cada potencia de dos se divide en 32
+// cubetas, así que cualquier percentil tiene un error relativo menor a 1/32 y la memoria
+// es fija sin importar cuántos frames se registren.
+class LatencyHistogram {
+public:
+    static const int kSubBits = 5;
+    static const int kSubBuckets = 1 << kSubBits;
+    static const int kMaxExponent = 44;  // Hasta ~4.9 horas
+    static const int kBuckets = (kMaxExponent - kSubBits + 2) * kSubBuckets;
+
+    LatencyHistogram() {
+        reset();
+    }
+
+    void reset() {
+        for (int i = 0; i < kBuckets; ++i) buckets_[i] = 0;
+        count_ = 0;
+        sum_ = 0.0;
+        max_ = 0;
+    }
+
+    void record(double seconds) {
+        std::uint64_t ns = seconds <= 0.0 ? 0 : static_cast<std::uint64_t>(seconds * 1e9);
+        ++buckets_[bucketOf(ns)];
+        ++count_;
+        sum_ += seconds;
+        if (ns > max_) max_ = ns;
+    }
+
+    std::uint64_t count() const {
+        return count_;
+    }
+
+    double mean() const {
+        return count_ ? sum_ / count_ : 0.0;
+    }
+
+    double max() const {
+        return max_ * 1e-9;
+    }
+
+    // Percentil p en [0, 100], en segundos (punto medio de la cubeta)
+    double percentile(double p) const {
+        if (count_ == 0) {
+            return 0.0;
+        }
+        std::uint64_t rank = static_cast<std::uint64_t>(p / 100.0 * (count_ - 1)) + 1;
+        std::uint64_t seen = 0;
+        for (int i = 0; i < kBuckets; ++i) {
+            seen += buckets_[i];
+            if (seen >= rank) {
+                double value = (bucketLow(i) + bucketLow(i + 1)) * 0.5e-9;
+                return value < max() ? value : max();
+            }
+        }
+        return max();
+    }
+
+private:
+    static int bucketOf(std::uint64_t ns) {
+        if (ns < static_cast<std::uint64_t>(kSubBuckets)) {
+            return static_cast<int>(ns);
+        }
+        int exponent = 63 - __builtin_clzll(ns);
+        if (exponent > kMaxExponent) {
+            return kBuckets - 1;
+        }
+        int sub = static_cast<int>((ns >> (exponent - kSubBits)) & (kSubBuckets - 1));
+        return (exponent - kSubBits + 1) * kSubBuckets + sub;
+    }
+
+    static double bucketLow(int index) {
+        if (index < kSubBuckets) {
+            return index;
+        }
+        int exponent = index / kSubBuckets + kSubBits - 1;
+        int sub = index % kSubBuckets;
+        return static_cast<double>((static_cast<std::uint64_t>(kSubBuckets) + sub) << (exponent - kSubBits));
+    }
+
+    std::uint64_t buckets_[kBuckets];
+    std::uint64_t count_;
+    double sum_;
+    std::uint64_t max_;
+};
+
+// Fases del frame que se miden por separado
+enum FramePhase {
+    kPhaseEvents,   // Procesar los eventos de la ventana
+    kPhaseUpdate,   // Actualizar las estrellas
+    kPhaseDraw,     // Construir y dibujar el lote de estrellas
+    kPhaseExtra,    // Estrellas adicionales
+    kPhaseDisplay,  // Mostrar la ventana
+    kPhaseIdle,     // Dormir hasta el siguiente frame (con límite de FPS)
+    kPhaseFrame,    // Frame completo
+    kPhaseCount
+};
+
+inline const char *phaseName(int phase) {
+    static const char *names[kPhaseCount] = {"eventos", "update", "dibujo", "extra", "display", "espera",
+                                                 "frame"};
+    return names[phase];
+}
+
+// Estadísticas de todas las fases, con volcado periódico a un archivo. Si el archivo
+// termina en .json cada volcado es un objeto JSON por línea; si no, filas CSV.
+class FrameStats {
+public:
+    void record(int phase, double seconds) {
+        phases_[phase].record(seconds);
+    }
+
+    const LatencyHistogram &phase(int phase) const {
+        return phases_[phase];
+    }
+
+    // Mide el tiempo desde la marca anterior, lo asigna a la fase indicada y lo devuelve
+    double lap(int phase) {
+        auto now = std::chrono::steady_clock::now();
+        double seconds = std::chrono::duration<double>(now - lap_).count();
+        record(phase, seconds);
+        lap_ = now;
+        return seconds;
+    }
+
+    void startLap() {
+        lap_ = std::chrono::steady_clock::now();
+    }
+
+    void setDumpFile(const std::string &path, double intervalSeconds) {
+        path_ = path;
+        interval_ = intervalSeconds;
+        json_ = path.size() >= 5 && path.compare(path.size() - 5, 5, ".json") == 0;
+        lastDump_ = start_;
+        std::ofstream out(path_, std::ios::trunc);
+        if (!json_) {
+            writeCsvHeader(out);
+        }
+    }
+
+    // Vuelca las estadísticas acumuladas si ya pasó el intervalo
+    void maybeDump() {
+        if (path_.empty()) {
+            return;
+        }
+        auto now = std::chrono::steady_clock::now();
+        if (std::chrono::duration<double>(now - lastDump_).count() >= interval_) {
+            dump();
+            lastDump_ = now;
+        }
+    }
+
+    void dump() const {
+        if (path_.empty()) {
+            return;
+        }
+        std::ofstream out(path_, std::ios::app);
+        if (json_) {
+            writeJson(out);
+        } else {
+            writeCsvRows(out);
+        }
+    }
+
+    static void writeCsvHeader(std::ostream &out) {
+        out << "tiempo_s,fase,frames,promedio_ms,p50_ms,p90_ms,p99_ms,max_ms\n";
+    }
+
+    void writeCsvRows(std::ostream &out) const {
+        double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_).count();
+        for (int p = 0; p < kPhaseCount; ++p) {
+            const LatencyHistogram &h = phases_[p];
+            if (h.count() == 0) continue;
+            out << elapsed << ',' << phaseName(p) << ',' << h.count() << ',' << h.mean() * 1e3 << ','
+                << h.percentile(50) * 1e3 << ',' << h.percentile(90) * 1e3 << ','
+                << h.percentile(99) * 1e3 << ',' << h.max() * 1e3 << '\n';
+        }
+    }
+
+    void writeJson(std::ostream &out) const {
+        double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_).count();
+        out << "{\"tiempo_s\":" << elapsed << ",\"fases\":{";
+        bool first = true;
+        for (int p = 0; p < kPhaseCount; ++p) {
+            const LatencyHistogram &h = phases_[p];
+            if (h.count() == 0) continue;
+            out << (first ? "" : ",") << '"' << phaseName(p) << "\":{\"frames\":" << h.count()
+                << ",\"promedio_ms\":" << h.mean() * 1e3 << ",\"p50_ms\":" << h.percentile(50) * 1e3
+                << ",\"p90_ms\":" << h.percentile(90) * 1e3 << ",\"p99_ms\":" << h.percentile(99) * 1e3
+                << ",\"max_ms\":" << h.max() * 1e3 << '}';
+            first = false;
+        }
+        out << "}}\n";
+    }
+
+    // Tabla legible al terminar el programa
+    void printSummary(std::ostream &out) const {
+        out << "fase      frames   prom_ms   p50_ms   p90_ms   p99_ms   max_ms\n";
+        for (int p = 0; p < kPhaseCount; ++p) {
+            const LatencyHistogram &h = phases_[p];
+            if (h.count() == 0) continue;
+            char line[160];
+            std::snprintf(line, sizeof(line), "%-8s %7llu %9.3f %8.3f %8.3f %8.3f %8.3f\n", phaseName(p),
+                          static_cast<unsigned long long>(h.count()), h.mean() * 1e3, h.percentile(50) * 1e3,
+                          h.percentile(90) * 1e3, h.percentile(99) * 1e3, h.max() * 1e3);
+            out << line;
+        }
+    }
+
+private:
+    LatencyHistogram phases_[kPhaseCount];
+    std::chrono::steady_clock::time_point start_ = std::chrono::steady_clock::now();
+    std::chrono::steady_clock::time_point lap_ = start_;
+    std::chrono::steady_clock::time_point lastDump_ = start_;
+    std::string path_;
+    double interval_ = 10.0;
+    bool json_ = false;
+};
+
+#endif //PARALLEL_SCREENSAVER_FRAME_STATS_H
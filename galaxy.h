@@ -0,0 +1,102 @@
+/*
+* Nombre: galaxy.h
+* Autores:
+  - Andrés Montoya, 21552
+  - Fernanda Esquivel, 21542
+  - Francisco Castillo, 21562
+* Descripción: Generación y actualización de la galaxia sobre el almacenamiento SoA (OpenMP).
+* Lenguaje: C++
+* Recursos: CLion
+* Historial:
+  - Creado el 17.10.2026
+  - Modificado el 17.10.2026 (política paralela intercambiable y primer acceso por bloques)
+  - Modificado el 17.10.2026 (sorteo de la estrella separado para el estado compacto)
+  - Modificado el 17.10.2026 (sorteo por índice global de la estrella)
+*/
+
+#ifndef PARALLEL_SCREENSAVER_GALAXY_H
+#define PARALLEL_SCREENSAVER_GALAXY_H
+
+#include <cmath>
+#include <cstdint>
+
+#include "counter_rng.h"
+#include "palette.h"
+#include "parallel_backend.h"
+#include "simd_update.h"
+#include "star_store.h"
+#include "star_update.h"
+
+// Cantidad de estrellas que procesa cada iteración del ciclo paralelo
+const int kUpdateBlock = 2048;
+
+// Sortear la estrella i en uno de los brazos de la galaxia
+inline void sampleStar(const GalaxyParams &params, int i, float &radius, float &angle, float &pointSize) {
+    const float angleIncrement = 0.70f; // Incremento de ángulo para los brazos espirales
+    const int numArms = 5;             // Número de brazos espirales
+
+    // Cada estrella tiene sus propios sorteos, así que no hay estado compartido entre hilos
+    // ni entre procesos (params.firstStar es el índice global de la estrella 0)
+    std::uint32_t star = params.firstStar + static_cast<std::uint32_t>(i);
+    float angleOffset = randomUniform(params.seed, kStreamInit, star, 0, 0) * 2 * 3.14159f;
+    int arm = static_cast<int>(randomUniform(params.seed, kStreamInit, star, 0, 1) * numArms);
+    float armAngle = (static_cast<float>(star) * angleIncrement) + (2 * 3.14159f / numArms) * arm + angleOffset * 0.5f;
+    radius = params.maxRadius * std::sqrt(randomUniform(params.seed, kStreamInit, star, 0, 2)) *
+             (0.9f + 0.2f * randomUniform(params.seed, kStreamInit, star, 0, 3));
+    angle = std::fmod(armAngle, kTwoPi);
+
+    // Un radio de 1 o 2 píxeles (círculos)
+    pointSize = randomUniform(params.seed, kStreamInit, star, 0, 4) < 0.3f ? 2.0f : 1.0f;
+}
+
+// Generar la estrella i en uno de los brazos de la galaxia
+inline void initStar(StarStore &stars, const GalaxyParams &params, int i) {
+    float radius, armAngle, pointSize;
+    sampleStar(params, i, radius, armAngle, pointSize);
+    stars.radius[i] = radius;
+    stars.angle[i] = armAngle;
+    stars.pointSize[i] = pointSize;
+    stars.generation[i] = 0;
+
+    // El color depende de la distancia desde el centro
+    stars.palette[i] = spawnPaletteIndex(radius / params.maxRadius);
+
+    stars.x[i] = params.centerX + radius * std::cos(armAngle);
+    stars.y[i] = params.centerY + radius * std::sin(armAngle);
+}
+
+// Generar los puntos en la galaxia. Se recorre por los mismos bloques y con la misma
+// política que la actualización, así que con el reparto estático cada hilo es el primero
+// en tocar (y, en NUMA, el dueño de) la memoria que después actualiza.
+inline void initGalaxy(StarStore &stars, const GalaxyParams &params,
+                       const ParallelPolicy &policy = ParallelPolicy()) {
+    int numPoints = static_cast<int>(stars.count());
+    int numBlocks = (numPoints + kUpdateBlock - 1) / kUpdateBlock;
+
+    parallelFor(policy, 0, numBlocks, [&](int block) {
+        int begin = block * kUpdateBlock;
+        int end = begin + kUpdateBlock < numPoints ? begin + kUpdateBlock : numPoints;
+        for (int i = begin; i < end; ++i) {
+            initStar(stars, params, i);
+        }
+    });
+}
+
+// Actualizar la posición de los puntos de la galaxia. El ángulo y el radio son el estado,
+// por lo que no hace falta recuperarlos de la posición con atan2 y sqrt. Los bloques
+// contiguos se reparten según la política elegida y cada uno usa el kernel vectorial
+// elegido según el procesador.
+inline void updateGalaxy(StarStore &stars, const GalaxyParams &params, SimdLevel level = SimdLevel::Auto,
+                         const ParallelPolicy &policy = ParallelPolicy()) {
+    UpdateKernel kernel = selectUpdateKernel(resolveSimdLevel(level));
+    int numPoints = static_cast<int>(stars.count());
+    int numBlocks = (numPoints + kUpdateBlock - 1) / kUpdateBlock;
+
+    parallelFor(policy, 0, numBlocks, [&](int block) {
+        int begin = block * kUpdateBlock;
+        int end = begin + kUpdateBlock < numPoints ? begin + kUpdateBlock : numPoints;
+        kernel(stars, params, begin, end);
+    });
+}
+
+#endif //PARALLEL_SCREENSAVER_GALAXY_H
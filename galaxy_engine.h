@@ -0,0 +1,129 @@
+/*
+* Nombre: galaxy_engine.h
+* Autores:
+  - Andrés Montoya, 21552
+  - Fernanda Esquivel, 21542
+  - Francisco Castillo, 21562
+* Descripción: Motor de la galaxia reutilizable y sin SFML: crear, avanzar y dibujar en un
+  framebuffer RGB. Varias instancias pueden vivir en el mismo proceso.
+* Lenguaje: C++
+* Recursos: CLion
+* Historial:
+  - Creado el 17.10.2026
+  - Modificado el 17.10.2026 (orden espacial de las estrellas)
+*/
+
+#ifndef PARALLEL_SCREENSAVER_GALAXY_ENGINE_H
+#define PARALLEL_SCREENSAVER_GALAXY_ENGINE_H
+
+#include <cstdint>
+
+#include "extra_stars.h"
+#include "galaxy.h"
+#include "incremental_rotation.h"
+#include "palette.h"
+#include "parallel_backend.h"
+#include "software_raster.h"
+#include "spatial_order.h"
+#include "star_store.h"
+#include "time_step.h"
+
+// Todo lo que define una galaxia. El centro es el del framebuffer.
+struct GalaxyConfig {
+    int numPoints = 30000;
+    int width = 800;
+    int height = 800;
+    float maxRadius = 450.0f;
+    float speed = 0.035f;
+    float baseRotationSpeed = 0.0007f;
+    std::uint64_t seed = 1;
+    PaletteKind palette = PaletteKind::Classic;
+    bool colorFollowsRadius = false;
+    float extraStarRate = 10.0f;
+    bool incrementalRotation = false;
+    int spatialOrder = 0;  // Pasos entre reordenamientos por celdas del framebuffer (0 = nunca)
+    SimdLevel simd = SimdLevel::Auto;
+    // Con varias galaxias en un proceso conviene el pool: sus ciclos paralelos se pueden
+    // anidar y todas las galaxias comparten los mismos hilos
+    ParallelPolicy parallel;
+    int tileSize = 64;
+};
+
+// Una galaxia: estado, estrellas adicionales, paleta y rasterizador propios. Nada es global,
+// así que cada instancia se puede avanzar y dibujar desde un hilo distinto.
+class GalaxyEngine {
+public:
+    explicit GalaxyEngine(const GalaxyConfig &config)
+        : config_(config), palette_(config.palette), extraStars_(config.extraStarRate),
+          rasterizer_(config.width, config.height, config.tileSize),
+          incremental_(config.simd, config.parallel),
+          order_(config.width, config.height, config.spatialOrder, config.parallel) {
+        params_.centerX = config.width / 2.0f;
+        params_.centerY = config.height / 2.0f;
+        params_.maxRadius = config.maxRadius;
+        params_.speed = config.speed;
+        params_.baseRotationSpeed = config.baseRotationSpeed;
+        params_.seed = config.seed;
+        palette_.setColorFollowsRadius(config.colorFollowsRadius, config.maxRadius);
+        rasterizer_.setPolicy(config.parallel);
+
+        stars_.resize(config.numPoints);
+        initGalaxy(stars_, params_, config.parallel);
+    }
+
+    // Avanza la galaxia seconds segundos de tiempo real (la fórmula cerrada de time_step.h)
+    void step(double seconds) {
+        if (seconds <= 0.0) {
+            return;
+        }
+        double ticks = seconds * kTicksPerSecond;
+        if (config_.incrementalRotation) {
+            incremental_.advance(stars_, params_, ticks);
+        } else {
+            advanceGalaxy(stars_, params_, ticks, config_.simd, config_.parallel);
+        }
+        if (config_.spatialOrder > 0) {
+            order_.maybeReorder(stars_);
+        }
+        extraStars_.update(static_cast<float>(seconds), params_);
+        simulatedSeconds_ += seconds;
+    }
+
+    // Dibuja el estado actual en frame (RGB24 de width x height; se redimensiona si hace falta)
+    void render(Framebuffer &frame) {
+        rasterizer_.render(stars_, palette_, extraStars_, frame);
+    }
+
+    const GalaxyConfig &config() const {
+        return config_;
+    }
+
+    const GalaxyParams &params() const {
+        return params_;
+    }
+
+    const StarStore &stars() const {
+        return stars_;
+    }
+
+    Palette &palette() {
+        return palette_;
+    }
+
+    double simulatedSeconds() const {
+        return simulatedSeconds_;
+    }
+
+private:
+    GalaxyConfig config_;
+    GalaxyParams params_;
+    StarStore stars_;
+    Palette palette_;
+    ExtraStarPool extraStars_;
+    TiledRasterizer rasterizer_;
+    IncrementalRotation incremental_;
+    SpatialOrder order_;
+    double simulatedSeconds_ = 0.0;
+};
+
+#endif //PARALLEL_SCREENSAVER_GALAXY_ENGINE_H
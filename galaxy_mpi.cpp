@@ -0,0 +1,308 @@
+/*
+ * Nombre: galaxy_mpi.cpp
+ * Autores:
+   - Andrés Montoya, 21552
+   - Fernanda Esquivel, 21542
+   - Francisco Castillo, 21562
+ * Descripción: Galaxia repartida entre varios procesos con MPI. Cada proceso actualiza un tramo
+   contiguo de estrellas y el proceso 0 compone el frame, con las posiciones reunidas o con la
+   reducción de la cobertura por píxel de cada tramo.
+ * Lenguaje: C++
+ * Recursos: CLion, OpenMP, MPI
+ * Historial:
+   - Creado el 17.10.2026
+*/
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <mpi.h>
+#include <omp.h>
+
+#include "extra_stars.h"
+#include "galaxy.h"
+#include "options.h"
+#include "palette.h"
+#include "software_raster.h"
+#include "star_store.h"
+#include "time_step.h"
+
+// Cómo llega cada frame al proceso 0
+enum class GatherMode {
+    Positions,  // x, y e índice de color de cada estrella (10 bytes por estrella)
+    Coverage    // Cobertura de cada píxel, reducida con MPI_MAX (8 bytes por píxel)
+};
+
+struct MpiOptions {
+    int numPoints = 1000000;
+    int width = 800;
+    int height = 800;
+    float maxRadius = 450.0f;
+    int frames = 300;
+    int threads = 0;              // 0 = los de OpenMP por defecto en cada proceso
+    GatherMode mode = GatherMode::Positions;
+    std::uint64_t seed = 1;
+    std::string outputPattern;
+    std::string rawOutput;
+};
+
+void printMpiUsage(const char *program) {
+    std::cout << "Uso: mpirun -np P " << program << " [opciones]\n"
+              << "  --points N            Estrellas de la galaxia completa (por defecto 1000000)\n"
+              << "  --width N             Ancho del frame (por defecto 800)\n"
+              << "  --height N            Alto del frame (por defecto 800)\n"
+              << "  --max-radius R        Radio de la galaxia (por defecto 450)\n"
+              << "  --frames N            Frames a simular (por defecto 300)\n"
+              << "  --threads N           Hilos de OpenMP por proceso\n"
+              << "  --gather MODO         positions (reunir posiciones, por defecto) o coverage (reducir la\n"
+              << "                        cobertura por pixel de cada proceso)\n"
+              << "  --seed N              Semilla de los numeros aleatorios\n"
+              << "  --output PATRON       Guardar los frames como PPM, p. ej. frames/galaxia_%05d.ppm\n"
+              << "  --raw ARCHIVO         Escribir los frames como RGB24 sin encabezado (- = salida estandar)\n"
+              << "  --help                Mostrar esta ayuda\n";
+}
+
+bool parseMpiOptions(int argc, char **argv, MpiOptions &options) {
+    for (int i = 1; i < argc; ++i) {
+        const char *arg = argv[i];
+        double value = 0.0;
+
+        if (std::strcmp(arg, "--help") == 0 || std::strcmp(arg, "-h") == 0) {
+            printMpiUsage(argv[0]);
+            return false;
+        } else if (std::strcmp(arg, "--points") == 0) {
+            if (!readValue(argc, argv, i, value) || !checkRange(arg, value, 1, kMaxLargePoints)) return false;
+            options.numPoints = static_cast<int>(value);
+        } else if (std::strcmp(arg, "--width") == 0) {
+            if (!readValue(argc, argv, i, value) || !checkRange(arg, value, 16, 8192)) return false;
+            options.width = static_cast<int>(value);
+        } else if (std::strcmp(arg, "--height") == 0) {
+            if (!readValue(argc, argv, i, value) || !checkRange(arg, value, 16, 8192)) return false;
+            options.height = static_cast<int>(value);
+        } else if (std::strcmp(arg, "--max-radius") == 0) {
+            if (!readValue(argc, argv, i, value) || !checkRange(arg, value, 1, 100000)) return false;
+            options.maxRadius = static_cast<float>(value);
+        } else if (std::strcmp(arg, "--frames") == 0) {
+            if (!readValue(argc, argv, i, value) || !checkRange(arg, value, 1, 100000000)) return false;
+            options.frames = static_cast<int>(value);
+        } else if (std::strcmp(arg, "--threads") == 0) {
+            if (!readValue(argc, argv, i, value) || !checkRange(arg, value, 1, 4096)) return false;
+            options.threads = static_cast<int>(value);
+        } else if (std::strcmp(arg, "--gather") == 0) {
+            if (i + 1 >= argc || (std::strcmp(argv[i + 1], "positions") != 0 && std::strcmp(argv[i + 1], "coverage") != 0)) {
+                std::cerr << "Valor invalido para --gather\n";
+                return false;
+            }
+            options.mode = std::strcmp(argv[++i], "positions") == 0 ? GatherMode::Positions : GatherMode::Coverage;
+        } else if (std::strcmp(arg, "--seed") == 0) {
+            if (!readValue(argc, argv, i, value) || !checkRange(arg, value, 0, 4294967295.0)) return false;
+            options.seed = static_cast<std::uint64_t>(value);
+        } else if (std::strcmp(arg, "--output") == 0) {
+            if (i + 1 >= argc) {
+                std::cerr << "Falta el valor de --output\n";
+                return false;
+            }
+            options.outputPattern = argv[++i];
+        } else if (std::strcmp(arg, "--raw") == 0) {
+            if (i + 1 >= argc) {
+                std::cerr << "Falta el valor de --raw\n";
+                return false;
+            }
+            options.rawOutput = argv[++i];
+        } else {
+            std::cerr << "Opcion desconocida: " << arg << "\n";
+            printMpiUsage(argv[0]);
+            return false;
+        }
+    }
+    return true;
+}
+
+// Tiempos acumulados de un proceso, en segundos
+struct RankTimes {
+    double update = 0.0;       // Actualizar su tramo
+    double render = 0.0;       // Dibujar la cobertura de su tramo (modo coverage)
+    double wait = 0.0;         // Esperar a los procesos más lentos antes de comunicar
+    double communicate = 0.0;  // La operación colectiva en sí
+    double compose = 0.0;      // Proceso 0: dibujar o resolver el frame completo
+    double write = 0.0;        // Proceso 0: escribir el frame
+};
+
+int main(int argc, char **argv) {
+    MPI_Init(&argc, &argv);
+    int rank = 0, ranks = 1;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &ranks);
+
+    // Todos los procesos leen las opciones; solo el 0 muestra los errores y la ayuda
+    if (rank != 0) {
+        std::cout.setstate(std::ios::failbit);
+        std::cerr.setstate(std::ios::failbit);
+    }
+    MpiOptions options;
+    bool parsed = parseMpiOptions(argc, argv, options);
+    std::cout.clear();
+    std::cerr.clear();
+    if (!parsed || options.numPoints < ranks) {
+        if (parsed && rank == 0) {
+            std::cerr << "Hay menos estrellas que procesos\n";
+        }
+        MPI_Finalize();
+        return 1;
+    }
+    if (options.threads > 0) {
+        omp_set_num_threads(options.threads);
+    }
+
+    // Tramo contiguo de este proceso. Los sorteos usan el índice global (params.firstStar),
+    // así que la galaxia es la misma con cualquier cantidad de procesos.
+    auto shardBegin = [&](int r) {
+        return static_cast<int>(static_cast<long long>(options.numPoints) * r / ranks);
+    };
+    int begin = shardBegin(rank);
+    int count = shardBegin(rank + 1) - begin;
+
+    GalaxyParams params;
+    params.centerX = options.width / 2.0f;
+    params.centerY = options.height / 2.0f;
+    params.maxRadius = options.maxRadius;
+    params.seed = options.seed;
+    params.firstStar = static_cast<std::uint32_t>(begin);
+
+    StarStore shard;
+    shard.resize(count);
+    initGalaxy(shard, params);
+
+    // Solo el proceso 0 dibuja el frame completo y lleva las estrellas adicionales
+    Palette palette;
+    ExtraStarPool extraStars;
+    TiledRasterizer rasterizer(options.width, options.height);
+    Framebuffer frame;
+    frame.resize(options.width, options.height);
+    StarStore composite;
+    std::vector<std::uint64_t> coverage, reduced;
+    std::vector<int> counts(ranks), displs(ranks);
+    for (int r = 0; r < ranks; ++r) {
+        displs[r] = shardBegin(r);
+        counts[r] = shardBegin(r + 1) - displs[r];
+    }
+
+    // En el modo positions el tamaño de cada punto no cambia: se reúne una sola vez
+    if (options.mode == GatherMode::Positions) {
+        if (rank == 0) {
+            composite.resize(options.numPoints);
+        }
+        MPI_Gatherv(shard.pointSize.data(), count, MPI_FLOAT, composite.pointSize.data(), counts.data(),
+                    displs.data(), MPI_FLOAT, 0, MPI_COMM_WORLD);
+    }
+
+    FrameWriter writer;
+    bool writing = rank == 0 && (!options.outputPattern.empty() || !options.rawOutput.empty());
+    int opened = 1;
+    if (rank == 0) {
+        if (!options.outputPattern.empty() && !writer.openSequence(options.outputPattern)) {
+            opened = 0;
+        }
+        if (!options.rawOutput.empty() && !writer.openRaw(options.rawOutput)) {
+            std::cerr << "No se pudo abrir " << options.rawOutput << "\n";
+            opened = 0;
+        }
+    }
+    MPI_Bcast(&opened, 1, MPI_INT, 0, MPI_COMM_WORLD);
+    if (!opened) {
+        MPI_Finalize();
+        return 1;
+    }
+
+    const double frameTime = 1.0 / 60.0;
+    RankTimes times;
+    MPI_Barrier(MPI_COMM_WORLD);
+    double totalStart = MPI_Wtime();
+    for (int f = 0; f < options.frames; ++f) {
+        double t0 = MPI_Wtime();
+        advanceGalaxy(shard, params, frameTime * kTicksPerSecond);
+        double t1 = MPI_Wtime();
+        if (options.mode == GatherMode::Coverage) {
+            rasterizer.renderCoverage(shard, params.firstStar, palette, coverage);
+        }
+        double t2 = MPI_Wtime();
+
+        // La barrera separa la espera por los procesos lentos (desbalance) de la transferencia
+        MPI_Barrier(MPI_COMM_WORLD);
+        double t3 = MPI_Wtime();
+        if (options.mode == GatherMode::Positions) {
+            MPI_Gatherv(shard.x.data(), count, MPI_FLOAT, composite.x.data(), counts.data(), displs.data(),
+                        MPI_FLOAT, 0, MPI_COMM_WORLD);
+            MPI_Gatherv(shard.y.data(), count, MPI_FLOAT, composite.y.data(), counts.data(), displs.data(),
+                        MPI_FLOAT, 0, MPI_COMM_WORLD);
+            MPI_Gatherv(shard.palette.data(), count, MPI_UINT16_T, composite.palette.data(), counts.data(),
+                        displs.data(), MPI_UINT16_T, 0, MPI_COMM_WORLD);
+        } else {
+            if (rank == 0) {
+                reduced.resize(coverage.size());
+            }
+            MPI_Reduce(coverage.data(), reduced.data(), static_cast<int>(coverage.size()), MPI_UINT64_T, MPI_MAX,
+                       0, MPI_COMM_WORLD);
+        }
+        double t4 = MPI_Wtime();
+
+        times.update += t1 - t0;
+        times.render += t2 - t1;
+        times.wait += t3 - t2;
+        times.communicate += t4 - t3;
+        if (rank != 0) {
+            continue;
+        }
+
+        extraStars.update(static_cast<float>(frameTime), params);
+        if (options.mode == GatherMode::Positions) {
+            rasterizer.render(composite, palette, extraStars, frame);
+        } else {
+            resolveCoverage(reduced, palette, extraStars, frame);
+        }
+        double t5 = MPI_Wtime();
+        times.compose += t5 - t4;
+        if (writing) {
+            if (!writer.write(frame)) {
+                std::cerr << "Error al escribir el frame " << f << "\n";
+                MPI_Abort(MPI_COMM_WORLD, 1);
+            }
+            times.write += MPI_Wtime() - t5;
+        }
+    }
+    MPI_Barrier(MPI_COMM_WORLD);
+    double totalTime = MPI_Wtime() - totalStart;
+
+    // El proceso 0 junta los tiempos de todos y escribe una fila por proceso
+    const int kFields = 6;
+    double local[kFields] = {times.update, times.render, times.wait, times.communicate, times.compose, times.write};
+    std::vector<double> all(rank == 0 ? static_cast<std::size_t>(ranks) * kFields : 0);
+    MPI_Gather(local, kFields, MPI_DOUBLE, all.data(), kFields, MPI_DOUBLE, 0, MPI_COMM_WORLD);
+
+    if (rank == 0) {
+        long long bytesPerFrame = options.mode == GatherMode::Positions
+                                  ? static_cast<long long>(options.numPoints) * 10
+                                  : static_cast<long long>(ranks) * options.width * options.height * 8;
+        // Si los frames van a stdout el reporte se escribe en stderr
+        std::ostream &report = writer.writesToStdout() ? std::cerr : std::cout;
+        report << "version,rango,procesos,hilos,estrellas,frames,modo,bytes_por_frame,actualizacion_ms,dibujo_ms,"
+                  "espera_ms,comunicacion_ms,composicion_ms,escritura_ms,total_s,frames_por_s\n";
+        for (int r = 0; r < ranks; ++r) {
+            const double *t = &all[static_cast<std::size_t>(r) * kFields];
+            report << "mpi," << r << ',' << ranks << ',' << omp_get_max_threads() << ','
+                   << (shardBegin(r + 1) - shardBegin(r)) << ',' << options.frames << ','
+                   << (options.mode == GatherMode::Positions ? "positions" : "coverage") << ',' << bytesPerFrame;
+            for (int k = 0; k < kFields; ++k) {
+                report << ',' << 1000.0 * t[k] / options.frames;
+            }
+            report << ',' << totalTime << ',' << options.frames / totalTime << '\n';
+        }
+        report.flush();
+    }
+
+    MPI_Finalize();
+    return 0;
+}
@@ -0,0 +1,254 @@
+/*
+ * Nombre: galaxy_wall.cpp
+ * Autores:
+   - Andrés Montoya, 21552
+   - Fernanda Esquivel, 21542
+   - Francisco Castillo, 21562
+ * Descripción: Muro de galaxias: varias galaxias independientes en un solo proceso, sin SFML,
+   que comparten un pool de hilos y se componen en una sola imagen (una por pantalla).
+ * Lenguaje: C++
+ * Recursos: CLion, OpenMP
+ * Historial:
+   - Creado el 17.10.2026
+   - Modificado el 17.10.2026 (orden espacial de las estrellas)
+*/
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+#include <omp.h>
+
+#include "galaxy_engine.h"
+#include "options.h"
+
+struct WallOptions {
+    int galaxies = 4;
+    int columns = 0;              // 0 = la raíz cuadrada redondeada hacia arriba
+    int width = 400;              // Tamaño de cada galaxia (una pantalla)
+    int height = 400;
+    int numPoints = 30000;
+    float maxRadius = 0.0f;       // 0 = proporcional al tamaño, como 450 en 800x800
+    int frames = 600;
+    int threads = 0;              // 0 = los de OpenMP por defecto
+    bool nested = true;           // Galaxias en paralelo (anidado) o una tras otra
+    bool incrementalRotation = false;
+    int spatialOrder = 0;
+    std::uint64_t seed = 1;
+    std::string outputPattern;
+    std::string rawOutput;
+};
+
+void printWallUsage(const char *program) {
+    std::cout << "Uso: " << program << " [opciones]\n"
+              << "  --galaxies N          Galaxias en el muro (por defecto 4)\n"
+              << "  --columns N           Galaxias por fila (por defecto la raiz cuadrada)\n"
+              << "  --width N             Ancho de cada galaxia en pixeles (por defecto 400)\n"
+              << "  --height N            Alto de cada galaxia en pixeles (por defecto 400)\n"
+              << "  --points N            Estrellas por galaxia (por defecto 30000)\n"
+              << "  --max-radius R        Radio de cada galaxia (por defecto proporcional al tamaño)\n"
+              << "  --frames N            Frames a simular (por defecto 600)\n"
+              << "  --threads N           Hilos del pool compartido\n"
+              << "  --schedule MODO       nested (galaxias en paralelo, por defecto) o sequential (una tras otra)\n"
+              << "  --incremental-rotation  Girar la posicion del frame anterior sin seno ni coseno\n"
+              << "  --spatial-order N     Reordenar las estrellas por celdas de la pantalla cada N frames (0 = nunca)\n"
+              << "  --seed N              Semilla de la primera galaxia; las demas usan las siguientes\n"
+              << "  --output PATRON       Guardar el muro como PPM, p. ej. muro_%05d.ppm\n"
+              << "  --raw ARCHIVO         Escribir el muro como RGB24 sin encabezado (- = salida estandar)\n"
+              << "  --help                Mostrar esta ayuda\n";
+}
+
+bool parseWallOptions(int argc, char **argv, WallOptions &options) {
+    for (int i = 1; i < argc; ++i) {
+        const char *arg = argv[i];
+        double value = 0.0;
+
+        if (std::strcmp(arg, "--help") == 0 || std::strcmp(arg, "-h") == 0) {
+            printWallUsage(argv[0]);
+            return false;
+        } else if (std::strcmp(arg, "--galaxies") == 0) {
+            if (!readValue(argc, argv, i, value) || !checkRange(arg, value, 1, 256)) return false;
+            options.galaxies = static_cast<int>(value);
+        } else if (std::strcmp(arg, "--columns") == 0) {
+            if (!readValue(argc, argv, i, value) || !checkRange(arg, value, 1, 256)) return false;
+            options.columns = static_cast<int>(value);
+        } else if (std::strcmp(arg, "--width") == 0) {
+            if (!readValue(argc, argv, i, value) || !checkRange(arg, value, 16, 8192)) return false;
+            options.width = static_cast<int>(value);
+        } else if (std::strcmp(arg, "--height") == 0) {
+            if (!readValue(argc, argv, i, value) || !checkRange(arg, value, 16, 8192)) return false;
+            options.height = static_cast<int>(value);
+        } else if (std::strcmp(arg, "--points") == 0) {
+            if (!readValue(argc, argv, i, value) || !checkRange(arg, value, 1, kMaxLargePoints)) return false;
+            options.numPoints = static_cast<int>(value);
+        } else if (std::strcmp(arg, "--max-radius") == 0) {
+            if (!readValue(argc, argv, i, value) || !checkRange(arg, value, 1, 100000)) return false;
+            options.maxRadius = static_cast<float>(value);
+        } else if (std::strcmp(arg, "--frames") == 0) {
+            if (!readValue(argc, argv, i, value) || !checkRange(arg, value, 1, 100000000)) return false;
+            options.frames = static_cast<int>(value);
+        } else if (std::strcmp(arg, "--threads") == 0) {
+            if (!readValue(argc, argv, i, value) || !checkRange(arg, value, 1, 4096)) return false;
+            options.threads = static_cast<int>(value);
+        } else if (std::strcmp(arg, "--schedule") == 0) {
+            if (i + 1 >= argc || (std::strcmp(argv[i + 1], "nested") != 0 && std::strcmp(argv[i + 1], "sequential") != 0)) {
+                std::cerr << "Valor invalido para --schedule\n";
+                return false;
+            }
+            options.nested = std::strcmp(argv[++i], "nested") == 0;
+        } else if (std::strcmp(arg, "--incremental-rotation") == 0) {
+            options.incrementalRotation = true;
+        } else if (std::strcmp(arg, "--spatial-order") == 0) {
+            if (!readValue(argc, argv, i, value) || !checkRange(arg, value, 0, 100000)) return false;
+            options.spatialOrder = static_cast<int>(value);
+        } else if (std::strcmp(arg, "--seed") == 0) {
+            if (!readValue(argc, argv, i, value) || !checkRange(arg, value, 0, 4294967295.0)) return false;
+            options.seed = static_cast<std::uint64_t>(value);
+        } else if (std::strcmp(arg, "--output") == 0) {
+            if (i + 1 >= argc) {
+                std::cerr << "Falta el valor de --output\n";
+                return false;
+            }
+            options.outputPattern = argv[++i];
+        } else if (std::strcmp(arg, "--raw") == 0) {
+            if (i + 1 >= argc) {
+                std::cerr << "Falta el valor de --raw\n";
+                return false;
+            }
+            options.rawOutput = argv[++i];
+        } else {
+            std::cerr << "Opcion desconocida: " << arg << "\n";
+            printWallUsage(argv[0]);
+            return false;
+        }
+    }
+    if (options.columns == 0) {
+        options.columns = static_cast<int>(std::ceil(std::sqrt(static_cast<double>(options.galaxies))));
+    }
+    options.columns = std::min(options.columns, options.galaxies);
+    if (options.maxRadius <= 0.0f) {
+        options.maxRadius = 450.0f * std::min(options.width, options.height) / 800.0f;
+    }
+    return true;
+}
+
+// Copia la imagen de una galaxia en su celda del muro
+void blitCell(const Framebuffer &cell, int column, int row, Framebuffer &wall) {
+    std::size_t rowBytes = static_cast<std::size_t>(cell.width) * 3;
+    for (int y = 0; y < cell.height; ++y) {
+        const std::uint8_t *src = &cell.pixels[static_cast<std::size_t>(y) * rowBytes];
+        std::uint8_t *dst = &wall.pixels[(static_cast<std::size_t>(row * cell.height + y) * wall.width +
+                                          static_cast<std::size_t>(column) * cell.width) * 3];
+        std::memcpy(dst, src, rowBytes);
+    }
+}
+
+int main(int argc, char **argv) {
+    WallOptions options;
+    if (!parseWallOptions(argc, argv, options)) {
+        return 1;
+    }
+    // El pool compartido se crea con los hilos de OpenMP la primera vez que se usa
+    if (options.threads > 0) {
+        omp_set_num_threads(options.threads);
+    }
+
+    // Todas las galaxias usan el mismo pool: un ciclo paralelo dentro de una galaxia encola
+    // sus bloques en el hilo que la atiende y los demás hilos se los roban cuando se quedan
+    // sin trabajo, así que no se crea un equipo de hilos por galaxia.
+    ParallelPolicy policy;
+    policy.backend = ParallelBackend::Pool;
+    const PaletteKind palettes[] = {PaletteKind::Classic, PaletteKind::Fire, PaletteKind::Ice};
+
+    auto initStart = std::chrono::steady_clock::now();
+    std::vector<std::unique_ptr<GalaxyEngine>> galaxies(options.galaxies);
+    WorkStealingPool::shared().parallelFor(0, options.galaxies, 1, [&](int first, int last) {
+        for (int g = first; g < last; ++g) {
+            GalaxyConfig config;
+            config.numPoints = options.numPoints;
+            config.width = options.width;
+            config.height = options.height;
+            config.maxRadius = options.maxRadius;
+            config.seed = options.seed + g;
+            config.palette = palettes[g % 3];
+            config.incrementalRotation = options.incrementalRotation;
+            config.spatialOrder = options.spatialOrder;
+            config.parallel = policy;
+            galaxies[g].reset(new GalaxyEngine(config));
+        }
+    });
+    double initTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - initStart).count();
+
+    int rows = (options.galaxies + options.columns - 1) / options.columns;
+    Framebuffer wall;
+    wall.resize(options.columns * options.width, rows * options.height);
+    std::vector<Framebuffer> cells(options.galaxies);
+
+    FrameWriter writer;
+    bool writing = !options.outputPattern.empty() || !options.rawOutput.empty();
+    if (!options.outputPattern.empty() && !writer.openSequence(options.outputPattern)) {
+        return 1;
+    }
+    if (!options.rawOutput.empty() && !writer.openRaw(options.rawOutput)) {
+        std::cerr << "No se pudo abrir " << options.rawOutput << "\n";
+        return 1;
+    }
+
+    // Cada frame del muro avanza todas las galaxias el mismo tiempo y termina cuando todas
+    // se dibujaron: ninguna puede adelantarse ni quedarse atrás. Se mide cuánto tarda cada
+    // una para ver si el reparto es parejo.
+    const double frameTime = 1.0 / 60.0;
+    std::vector<double> galaxySeconds(options.galaxies, 0.0);
+    auto frameGalaxy = [&](int g) {
+        auto start = std::chrono::steady_clock::now();
+        galaxies[g]->step(frameTime);
+        galaxies[g]->render(cells[g]);
+        blitCell(cells[g], g % options.columns, g / options.columns, wall);
+        galaxySeconds[g] += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    };
+
+    double writeTime = 0.0;
+    auto totalStart = std::chrono::steady_clock::now();
+    for (int f = 0; f < options.frames; ++f) {
+        if (options.nested) {
+            WorkStealingPool::shared().parallelFor(0, options.galaxies, 1, [&](int first, int last) {
+                for (int g = first; g < last; ++g) {
+                    frameGalaxy(g);
+                }
+            });
+        } else {
+            for (int g = 0; g < options.galaxies; ++g) {
+                frameGalaxy(g);
+            }
+        }
+        if (writing) {
+            auto writeStart = std::chrono::steady_clock::now();
+            if (!writer.write(wall)) {
+                std::cerr << "Error al escribir el frame " << f << "\n";
+                return 1;
+            }
+            writeTime += std::chrono::duration<double>(std::chrono::steady_clock::now() - writeStart).count();
+        }
+    }
+    double totalTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - totalStart).count();
+
+    auto range = std::minmax_element(galaxySeconds.begin(), galaxySeconds.end());
+    double fastest = 1000.0 * *range.first / options.frames;
+    double slowest = 1000.0 * *range.second / options.frames;
+
+    // Si los frames van a stdout el reporte se escribe en stderr
+    std::ostream &report = writer.writesToStdout() ? std::cerr : std::cout;
+    report << "version,galaxias,hilos,puntos,ancho,alto,frames,reparto,init_s,escritura_s,total_s,frames_por_s,"
+              "galaxia_ms_min,galaxia_ms_max,desbalance\n";
+    report << "muro," << options.galaxies << ',' << WorkStealingPool::shared().threadCount() << ','
+           << options.numPoints << ',' << wall.width << ',' << wall.height << ',' << options.frames << ','
+           << (options.nested ? "nested" : "sequential") << ',' << initTime << ',' << writeTime << ','
+           << totalTime << ',' << options.frames / totalTime << ',' << fastest << ',' << slowest << ','
+           << (fastest > 0.0 ? slowest / fastest : 1.0) << std::endl;
+    return 0;
+}
@@ -0,0 +1,277 @@
+/*
+* Nombre: incremental_rotation.h
+* Autores:
+  - Andrés Montoya, 21552
+  - Fernanda Esquivel, 21542
+  - Francisco Castillo, 21562
+* Descripción: Actualización sin funciones trigonométricas: la posición de cada estrella se gira
+  desde la del frame anterior con el factor (cos, sin) de su giro por paso y se escala por la
+  atracción, con renormalización periódica desde el radio y el ángulo.
+* Lenguaje: C++
+* Recursos: CLion
+* Historial:
+  - Creado el 17.10.2026
+*/
+
+#ifndef PARALLEL_SCREENSAVER_INCREMENTAL_ROTATION_H
+#define PARALLEL_SCREENSAVER_INCREMENTAL_ROTATION_H
+
+#include <algorithm>
+#include <cstdint>
+
+#include "galaxy.h"
+#include "parallel_backend.h"
+#include "simd_update.h"
+#include "star_store.h"
+#include "star_update.h"
+#include "time_step.h"
+
+// Cada bloque de estrellas se recalcula con el kernel exacto una vez cada tantos pasos
+const int kRenormalizePeriod = 64;
+
+// Giro máximo por paso para el factor de dos términos. Con t <= 0.05 rad el error de
+// cos t ≈ 1 - t²/2 y sin t ≈ t - t³/6 es a lo más t⁴/24 ≈ 3e-7, menos que la precisión
+// de un float en la posición; el giro de un tick con los parámetros permitidos es a lo más
+// 2·0.007 rad. Pasos más largos usan el kernel exacto.
+const float kMaxIncrementTurn = 0.05f;
+
+// Un paso de las estrellas [begin, end) sin instrucciones vectoriales: el desplazamiento desde
+// el centro se gira con el factor de su giro t = b·(2 - r/R) y se escala por r'/r. El radio y
+// el ángulo siguen siendo el estado, así que la reaparición y el resto del programa no cambian.
+inline void updateStarsIncrementalScalar(StarStore &stars, const GalaxyParams &params, int begin, int end) {
+    const float invRadius = 1.0f / params.maxRadius;
+
+    for (int i = begin; i < end; ++i) {
+        float radius = stars.radius[i];
+        float factor = 2.0f - radius * invRadius;
+        float next = radius - params.speed * factor;
+        float turn = params.baseRotationSpeed * factor;
+
+        float angle = stars.angle[i] + turn;
+        if (angle >= kTwoPi) angle -= kTwoPi;
+        stars.angle[i] = angle;
+        if (next < 0) {
+            respawnStar(stars, params, i);
+            continue;
+        }
+
+        float turn2 = turn * turn;
+        float scale = next / radius;
+        float c = (1.0f - 0.5f * turn2) * scale;
+        float s = (turn - turn * turn2 * (1.0f / 6.0f)) * scale;
+        float dx = stars.x[i] - params.centerX;
+        float dy = stars.y[i] - params.centerY;
+        stars.radius[i] = next;
+        stars.x[i] = params.centerX + dx * c - dy * s;
+        stars.y[i] = params.centerY + dx * s + dy * c;
+    }
+}
+
+#ifdef GALAXY_HAS_X86_SIMD
+
+// ---------------------------------------------------------------- SSE2: 4 estrellas
+__attribute__((target("sse2")))
+inline void updateStarsIncrementalSSE2(StarStore &stars, const GalaxyParams &params, int begin, int end) {
+    const __m128 invRadius = _mm_set1_ps(1.0f / params.maxRadius);
+    const __m128 two = _mm_set1_ps(2.0f);
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 half = _mm_set1_ps(0.5f);
+    const __m128 sixth = _mm_set1_ps(1.0f / 6.0f);
+    const __m128 rotation = _mm_set1_ps(params.baseRotationSpeed);
+    const __m128 speed = _mm_set1_ps(params.speed);
+    const __m128 twoPi = _mm_set1_ps(kTwoPi);
+    const __m128 centerX = _mm_set1_ps(params.centerX);
+    const __m128 centerY = _mm_set1_ps(params.centerY);
+
+    int i = begin;
+    for (; i + 4 <= end; i += 4) {
+        __m128 radius = _mm_loadu_ps(&stars.radius[i]);
+        __m128 angle = _mm_loadu_ps(&stars.angle[i]);
+        __m128 dx = _mm_sub_ps(_mm_loadu_ps(&stars.x[i]), centerX);
+        __m128 dy = _mm_sub_ps(_mm_loadu_ps(&stars.y[i]), centerY);
+
+        __m128 factor = _mm_sub_ps(two, _mm_mul_ps(radius, invRadius));
+        __m128 turn = _mm_mul_ps(rotation, factor);
+        __m128 next = _mm_sub_ps(radius, _mm_mul_ps(speed, factor));
+        angle = _mm_add_ps(angle, turn);
+        angle = _mm_sub_ps(angle, _mm_and_ps(_mm_cmpge_ps(angle, twoPi), twoPi));
+
+        // cos t ≈ 1 - t²/2 y sin t ≈ t·(1 - t²/6), ya multiplicados por r'/r
+        __m128 turn2 = _mm_mul_ps(turn, turn);
+        __m128 scale = _mm_div_ps(next, radius);
+        __m128 c = _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(half, turn2)), scale);
+        __m128 s = _mm_mul_ps(_mm_mul_ps(turn, _mm_sub_ps(one, _mm_mul_ps(sixth, turn2))), scale);
+        _mm_storeu_ps(&stars.angle[i], angle);
+        _mm_storeu_ps(&stars.radius[i], next);
+        _mm_storeu_ps(&stars.x[i], _mm_add_ps(centerX, _mm_sub_ps(_mm_mul_ps(dx, c), _mm_mul_ps(dy, s))));
+        _mm_storeu_ps(&stars.y[i], _mm_add_ps(centerY, _mm_add_ps(_mm_mul_ps(dx, s), _mm_mul_ps(dy, c))));
+
+        // Solo las estrellas que cruzaron el centro pasan por la reaparición escalar
+        int respawn = _mm_movemask_ps(_mm_cmplt_ps(next, _mm_setzero_ps()));
+        while (respawn) {
+            int lane = __builtin_ctz(respawn);
+            respawnStar(stars, params, i + lane);
+            respawn &= respawn - 1;
+        }
+    }
+    updateStarsIncrementalScalar(stars, params, i, end);
+}
+
+// ---------------------------------------------------------------- AVX2: 8 estrellas
+__attribute__((target("avx2,fma")))
+inline void updateStarsIncrementalAVX2(StarStore &stars, const GalaxyParams &params, int begin, int end) {
+    const __m256 invRadius = _mm256_set1_ps(1.0f / params.maxRadius);
+    const __m256 two = _mm256_set1_ps(2.0f);
+    const __m256 one = _mm256_set1_ps(1.0f);
+    const __m256 half = _mm256_set1_ps(0.5f);
+    const __m256 sixth = _mm256_set1_ps(1.0f / 6.0f);
+    const __m256 rotation = _mm256_set1_ps(params.baseRotationSpeed);
+    const __m256 speed = _mm256_set1_ps(params.speed);
+    const __m256 twoPi = _mm256_set1_ps(kTwoPi);
+    const __m256 centerX = _mm256_set1_ps(params.centerX);
+    const __m256 centerY = _mm256_set1_ps(params.centerY);
+
+    int i = begin;
+    for (; i + 8 <= end; i += 8) {
+        __m256 radius = _mm256_loadu_ps(&stars.radius[i]);
+        __m256 angle = _mm256_loadu_ps(&stars.angle[i]);
+        __m256 dx = _mm256_sub_ps(_mm256_loadu_ps(&stars.x[i]), centerX);
+        __m256 dy = _mm256_sub_ps(_mm256_loadu_ps(&stars.y[i]), centerY);
+
+        __m256 factor = _mm256_fnmadd_ps(radius, invRadius, two);
+        __m256 turn = _mm256_mul_ps(rotation, factor);
+        __m256 next = _mm256_fnmadd_ps(speed, factor, radius);
+        angle = _mm256_add_ps(angle, turn);
+        angle = _mm256_sub_ps(angle, _mm256_and_ps(_mm256_cmp_ps(angle, twoPi, _CMP_GE_OQ), twoPi));
+
+        __m256 turn2 = _mm256_mul_ps(turn, turn);
+        __m256 scale = _mm256_div_ps(next, radius);
+        __m256 c = _mm256_mul_ps(_mm256_fnmadd_ps(half, turn2, one), scale);
+        __m256 s = _mm256_mul_ps(_mm256_mul_ps(turn, _mm256_fnmadd_ps(sixth, turn2, one)), scale);
+        _mm256_storeu_ps(&stars.angle[i], angle);
+        _mm256_storeu_ps(&stars.radius[i], next);
+        _mm256_storeu_ps(&stars.x[i], _mm256_add_ps(centerX, _mm256_fmsub_ps(dx, c, _mm256_mul_ps(dy, s))));
+        _mm256_storeu_ps(&stars.y[i], _mm256_add_ps(centerY, _mm256_fmadd_ps(dx, s, _mm256_mul_ps(dy, c))));
+
+        int respawn = _mm256_movemask_ps(_mm256_cmp_ps(next, _mm256_setzero_ps(), _CMP_LT_OQ));
+        while (respawn) {
+            int lane = __builtin_ctz(respawn);
+            respawnStar(stars, params, i + lane);
+            respawn &= respawn - 1;
+        }
+    }
+    updateStarsIncrementalScalar(stars, params, i, end);
+}
+
+// ---------------------------------------------------------------- AVX-512: 16 estrellas
+__attribute__((target("avx512f")))
+inline void updateStarsIncrementalAVX512(StarStore &stars, const GalaxyParams &params, int begin, int end) {
+    const __m512 invRadius = _mm512_set1_ps(1.0f / params.maxRadius);
+    const __m512 two = _mm512_set1_ps(2.0f);
+    const __m512 one = _mm512_set1_ps(1.0f);
+    const __m512 half = _mm512_set1_ps(0.5f);
+    const __m512 sixth = _mm512_set1_ps(1.0f / 6.0f);
+    const __m512 rotation = _mm512_set1_ps(params.baseRotationSpeed);
+    const __m512 speed = _mm512_set1_ps(params.speed);
+    const __m512 twoPi = _mm512_set1_ps(kTwoPi);
+    const __m512 centerX = _mm512_set1_ps(params.centerX);
+    const __m512 centerY = _mm512_set1_ps(params.centerY);
+
+    int i = begin;
+    for (; i + 16 <= end; i += 16) {
+        __m512 radius = _mm512_loadu_ps(&stars.radius[i]);
+        __m512 angle = _mm512_loadu_ps(&stars.angle[i]);
+        __m512 dx = _mm512_sub_ps(_mm512_loadu_ps(&stars.x[i]), centerX);
+        __m512 dy = _mm512_sub_ps(_mm512_loadu_ps(&stars.y[i]), centerY);
+
+        __m512 factor = _mm512_fnmadd_ps(radius, invRadius, two);
+        __m512 turn = _mm512_mul_ps(rotation, factor);
+        __m512 next = _mm512_fnmadd_ps(speed, factor, radius);
+        angle = _mm512_add_ps(angle, turn);
+        angle = _mm512_mask_sub_ps(angle, _mm512_cmp_ps_mask(angle, twoPi, _CMP_GE_OQ), angle, twoPi);
+
+        __m512 turn2 = _mm512_mul_ps(turn, turn);
+        __m512 scale = _mm512_div_ps(next, radius);
+        __m512 c = _mm512_mul_ps(_mm512_fnmadd_ps(half, turn2, one), scale);
+        __m512 s = _mm512_mul_ps(_mm512_mul_ps(turn, _mm512_fnmadd_ps(sixth, turn2, one)), scale);
+        _mm512_storeu_ps(&stars.angle[i], angle);
+        _mm512_storeu_ps(&stars.radius[i], next);
+        _mm512_storeu_ps(&stars.x[i], _mm512_add_ps(centerX, _mm512_fmsub_ps(dx, c, _mm512_mul_ps(dy, s))));
+        _mm512_storeu_ps(&stars.y[i], _mm512_add_ps(centerY, _mm512_fmadd_ps(dx, s, _mm512_mul_ps(dy, c))));
+
+        unsigned respawn = _mm512_cmp_ps_mask(next, _mm512_setzero_ps(), _CMP_LT_OQ);
+        while (respawn) {
+            int lane = __builtin_ctz(respawn);
+            respawnStar(stars, params, i + lane);
+            respawn &= respawn - 1;
+        }
+    }
+    updateStarsIncrementalScalar(stars, params, i, end);
+}
+
+#endif // GALAXY_HAS_X86_SIMD
+
+// Kernel incremental para un nivel ya resuelto con resolveSimdLevel
+inline UpdateKernel selectIncrementalKernel(SimdLevel level) {
+#ifdef GALAXY_HAS_X86_SIMD
+    switch (level) {
+        case SimdLevel::AVX512: return updateStarsIncrementalAVX512;
+        case SimdLevel::AVX2: return updateStarsIncrementalAVX2;
+        case SimdLevel::SSE2: return updateStarsIncrementalSSE2;
+        default: break;
+    }
+#endif
+    (void) level;
+    return updateStarsIncrementalScalar;
+}
+
+// Actualización incremental. El redondeo de cada giro se acumula en la posición, así que cada
+// bloque se renormaliza cada kRenormalizePeriod pasos: ese paso usa el kernel exacto, que
+// recalcula x e y desde el radio y el ángulo. Los bloques se turnan para repartir el costo.
+class IncrementalRotation {
+public:
+    explicit IncrementalRotation(SimdLevel level = SimdLevel::Auto, const ParallelPolicy &policy = ParallelPolicy())
+        : level_(level), policy_(policy), exact_(selectUpdateKernel(resolveSimdLevel(level))),
+          incremental_(selectIncrementalKernel(resolveSimdLevel(level))) {}
+
+    // Mismo contrato que el paso de la simulación: ticks = 0 es un tick del ciclo original
+    void advance(StarStore &stars, const GalaxyParams &params, double ticks) {
+        GalaxyParams stepParams = ticks > 0.0 ? scaledParams(params, makeTimeStep(params, ticks)) : params;
+        if (2.0f * stepParams.baseRotationSpeed > kMaxIncrementTurn) {
+            if (ticks > 0.0) {
+                advanceGalaxy(stars, params, ticks, level_, policy_);
+            } else {
+                updateGalaxy(stars, params, level_, policy_);
+            }
+            return;
+        }
+
+        std::uint64_t phase = steps_++;
+        auto kernel = [this, phase](StarStore &state, const GalaxyParams &scaled, int begin, int end) {
+            if ((begin / kUpdateBlock + phase) % kRenormalizePeriod == 0) {
+                exact_(state, scaled, begin, end);
+            } else {
+                incremental_(state, scaled, begin, end);
+            }
+        };
+        if (ticks > 0.0) {
+            advanceGalaxyWith(stars, params, ticks, policy_, kernel);
+            return;
+        }
+        int numPoints = static_cast<int>(stars.count());
+        int numBlocks = (numPoints + kUpdateBlock - 1) / kUpdateBlock;
+        parallelFor(policy_, 0, numBlocks, [&](int block) {
+            int begin = block * kUpdateBlock;
+            kernel(stars, params, begin, std::min(begin + kUpdateBlock, numPoints));
+        });
+    }
+
+private:
+    SimdLevel level_;
+    ParallelPolicy policy_;
+    UpdateKernel exact_;
+    UpdateKernel incremental_;
+    std::uint64_t steps_ = 0;
+};
+
+#endif //PARALLEL_SCREENSAVER_INCREMENTAL_ROTATION_H
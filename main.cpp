@@ -10,6 +10,9 @@
  * Historial:
    - Creado el 24.08.2024
    - Modificado el 04.09.2024
+   - Modificado el 17.10.2026 (modo headless para medir tiempos)
+   - Modificado el 17.10.2026 (lógica de la galaxia movida a sequential.h)
+   - Modificado el 17.10.2026 (solo acepta las opciones que usa)
 */
 
 #include <SFML/Graphics.hpp>
@@ -20,6 +23,9 @@
 #include <iostream>
 #include <limits>
 
+#include "options.h"
+#include "sequential.h"
+
 // Estructura para manejar la estrella adicional
 struct Star {
     sf::ConvexShape shape;
@@ -96,17 +102,56 @@ void askParameters(int &numPoints, float &maxRadius, float &speed, float &baseRo
     }
 }
 
-int main() {
-    // Parámetros por defecto de la galaxia
-    int numPoints = 15000;             // Número de puntos en la galaxia
-    float maxRadius = 450.0f;          // Radio máximo de la galaxia
-    const float angleIncrement = 0.70f; // Incremento de ángulo para los brazos espirales
-    float speed = 0.035f;              // Velocidad de los puntos moviéndose hacia el centro
-    float baseRotationSpeed = 0.0007f; // Velocidad base de la rotación de la galaxia
-    const int numArms = 5;             // Número de brazos espirales
+// Simular la galaxia sin ventana e imprimir los tiempos en formato CSV
+int runHeadless(const Options &options) {
+    // Mismo centro que la ventana de 800x800
+    sf::Vector2f center(400.0f, 400.0f);
+    std::vector<sf::CircleShape> points(options.numPoints);
+
+    sf::Clock clock;
+    initGalaxy(points, center, options.maxRadius);
+    float initTime = clock.restart().asSeconds();
+
+    for (int frame = 0; frame < options.frames; ++frame) {
+        updateGalaxy(points, center, options.maxRadius, options.speed, options.baseRotationSpeed);
+    }
+    float updateTime = clock.restart().asSeconds();
+
+    std::cout << "version,hilos,puntos,radio_max,velocidad,rotacion,semilla,frames,"
+                 "init_s,update_s,update_ms_por_frame,frames_por_s\n";
+    std::cout << "secuencial,1," << options.numPoints << ','
+              << options.maxRadius << ',' << options.speed << ',' << options.baseRotationSpeed << ','
+              << (options.hasSeed ? options.seed : 1) << ','
+              << options.frames << ',' << initTime << ',' << updateTime << ','
+              << 1000.0f * updateTime / options.frames << ',' << options.frames / updateTime << std::endl;
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    Options options;
+    if (!parseSequentialOptions(argc, argv, options)) {
+        return 1;
+    }
+
+    // Parámetros de la galaxia
+    int numPoints = options.numPoints;                 // Número de puntos en la galaxia
+    float maxRadius = options.maxRadius;               // Radio máximo de la galaxia
+    float speed = options.speed;                       // Velocidad de los puntos moviéndose hacia el centro
+    float baseRotationSpeed = options.baseRotationSpeed; // Velocidad base de la rotación de la galaxia
+
+    // Sin semilla explícita se conserva la secuencia por defecto de rand()
+    if (options.hasSeed) {
+        srand(options.seed);
+    }
+
+    if (options.headless) {
+        return runHeadless(options);
+    }
 
     // Solicitar los parámetros al usuario
-    askParameters(numPoints, maxRadius, speed, baseRotationSpeed);
+    if (options.interactive) {
+        askParameters(numPoints, maxRadius, speed, baseRotationSpeed);
+    }
 
     // Crear la ventana
     sf::RenderWindow window(sf::VideoMode(800, 800), "Spiral Galaxy");
@@ -139,45 +184,7 @@ int main() {
     // Almacenar los tiempos de frame para calcular el promedio
     std::vector<float> frameTimes;
 
-    // Generar los puntos en la galaxia (como círculos)
-    for (int i = 0; i < numPoints; ++i) {
-        // Añadir un desplazamiento aleatorio al ángulo
-        float angleOffset = static_cast<float>(rand()) / RAND_MAX * 2 * 3.14159f;
-        float armAngle = (i * angleIncrement) + (2 * 3.14159f / numArms) * (rand() % numArms) + angleOffset * 0.5f;
-
-        // Calcular la posición inicial del punto
-        float radius = maxRadius * std::sqrt(static_cast<float>(rand() % 1000) / 1000.0f) * (0.9f + 0.2f * (static_cast<float>(rand()) / RAND_MAX));
-
-        // Calcular la posición del punto
-        float x = center.x + radius * std::cos(armAngle);
-        float y = center.y + radius * std::sin(armAngle);
-
-        // Crear un punto con un radio de 1 o 2 píxeles (círculos)
-        sf::CircleShape star((rand() % 10) < 3 ? 2.0f : 1.0f);
-        star.setPosition(x, y);
-
-        // Determinar el color basado en la distancia desde el centro
-        sf::Color color;
-        float normalizedRadius = radius / maxRadius;
-        if (normalizedRadius < 0.3f) {
-            // Amarillo oscuro hacia el centro
-            color = sf::Color(200, 200, 100 + static_cast<sf::Uint8>(55 * normalizedRadius / 0.3f));
-        } else if (normalizedRadius < 0.7f) {
-            // Azul oscuro en la zona media
-            color = sf::Color(
-                static_cast<sf::Uint8>(100 * (1 - (normalizedRadius - 0.3f) / 0.4f)),
-                static_cast<sf::Uint8>(100 + 55 * (normalizedRadius - 0.3f) / 0.4f),
-                200);
-        } else {
-            // Violeta oscuro en los bordes
-            color = sf::Color(80 + static_cast<sf::Uint8>(127 * (normalizedRadius - 0.7f) / 0.3f), 0, 180);
-        }
-
-        star.setFillColor(color);
-
-        // Añadir el punto al vector
-        points[i] = star;
-    }
+    initGalaxy(points, center, maxRadius);
 
     // Bucle principal
     while (window.isOpen()) {
@@ -199,77 +206,10 @@ int main() {
 
         window.clear(sf::Color::Black); // Limpiar la ventana con un color negro
 
-        // Actualizar la posición de los puntos (círculos de la galaxia)
-        for (int i = 0; i < numPoints; ++i) {
-            // Obtener la posición actual del punto
-            sf::Vector2f pos = points[i].getPosition();
-
-            // Calcular la distancia desde el centro
-            float dx = pos.x - center.x;
-            float dy = pos.y - center.y;
-
-            // Calcular el ángulo y radio del punto
-            float angle = std::atan2(dy, dx);
-            float radius = std::sqrt(dx * dx + dy * dy);
-
-            // Ajustar la velocidad de rotación en función de la distancia desde el centro
-            float rotationSpeed = baseRotationSpeed * (1.0f + (maxRadius - radius) / maxRadius);
-
-            // Rotar el punto más rápido si está más cerca del centro
-            angle += rotationSpeed;
-
-            float attractionSpeed = speed * (1.0f + (maxRadius - radius) / maxRadius);
-
-            // Mover el punto hacia el centro
-            radius -= attractionSpeed;
-
-            // Si el punto está demasiado cerca del centro, moverlo al borde de la galaxia
-            if (radius < 0) {
-                radius = maxRadius;
-
-                // Añadir alguna variación aleatoria al ángulo y radio
-                angle += static_cast<float>(rand()) / RAND_MAX * 0.2f - 0.1f;
-                radius *= 0.9f + static_cast<float>(rand()) / RAND_MAX * 0.2f;
-
-                // Establecer un nuevo color para el punto basado en la distancia
-                float normalizedRadius = radius / maxRadius;
-                sf::Color newColor;
-
-                // Usar un ciclo para cambiar los colores de forma continua
-                if (normalizedRadius < 0.3f) {
-                    // Amarillo oscuro hacia el centro
-                    newColor = sf::Color(200, 200, 100 + static_cast<sf::Uint8>(55 * normalizedRadius / 0.3f));
-                } else if (normalizedRadius < 0.7f) {
-                    // Azul oscuro en la zona media
-                    newColor = sf::Color(
-                        static_cast<sf::Uint8>(100 * (1 - (normalizedRadius - 0.3f) / 0.4f)),
-                        static_cast<sf::Uint8>(100 + 55 * (normalizedRadius - 0.3f) / 0.4f),
-                        200);
-                } else {
-                    // Volver al color amarillo para continuar el ciclo en lugar de quedarse en violeta
-                    float cycleRadius = fmod(normalizedRadius - 0.7f, 1.0f);  // Usar fmod para reiniciar el ciclo
-                    if (cycleRadius < 0.3f) {
-                        newColor = sf::Color(200, 200, 100 + static_cast<sf::Uint8>(55 * cycleRadius / 0.3f));
-                    } else if (cycleRadius < 0.7f) {
-                        newColor = sf::Color(
-                            static_cast<sf::Uint8>(100 * (1 - (cycleRadius - 0.3f) / 0.4f)),
-                            static_cast<sf::Uint8>(100 + 55 * (cycleRadius - 0.3f) / 0.4f),
-                            200);
-                    } else {
-                        newColor = sf::Color(80 + static_cast<sf::Uint8>(127 * (cycleRadius - 0.7f) / 0.3f), 0, 180);
-                    }
-                }
-
-                points[i].setFillColor(newColor);
-            }
-
-            // Calcular la nueva posición del punto
-            float x = center.x + radius * std::cos(angle);
-            float y = center.y + radius * std::sin(angle);
-
-            // Establecer la nueva posición del punto
-            points[i].setPosition(x, y);
+        updateGalaxy(points, center, maxRadius, speed, baseRotationSpeed);
 
+        // Dibujar los puntos de la galaxia
+        for (int i = 0; i < numPoints; ++i) {
             // Dibujar el punto
             window.draw(points[i]);
         }
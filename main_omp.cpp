@@ -10,6 +10,32 @@
 * Historial:
   - Creado el 03.09.2024
   - Modificado el 04.09.2024
+  - Modificado el 17.10.2026 (modo headless para medir tiempos)
+  - Modificado el 17.10.2026 (estrellas en estructura de arreglos polar)
+  - Modificado el 17.10.2026 (dibujo de las estrellas en un solo lote)
+  - Modificado el 17.10.2026 (kernel vectorial de actualización)
+  - Modificado el 17.10.2026 (números aleatorios por contador, sin carreras entre hilos)
+  - Modificado el 17.10.2026 (paletas de color precalculadas)
+  - Modificado el 17.10.2026 (estrellas adicionales en un búfer circular)
+  - Modificado el 17.10.2026 (simulación y dibujo en paralelo con triple búfer)
+  - Modificado el 17.10.2026 (dibujo en CPU por mosaicos con salida a imágenes)
+  - Modificado el 17.10.2026 (histogramas de tiempo por fase en lugar de guardar cada frame)
+  - Modificado el 17.10.2026 (modo de millones de estrellas con dibujo por densidad)
+  - Modificado el 17.10.2026 (avance por tiempo independiente de los FPS)
+  - Modificado el 17.10.2026 (políticas paralelas intercambiables, sin la barrera sin efecto)
+  - Modificado el 17.10.2026 (modo gravitacional de N cuerpos)
+  - Modificado el 17.10.2026 (snapshots mapeados en memoria y checkpoints)
+  - Modificado el 17.10.2026 (control adaptativo de calidad)
+  - Modificado el 17.10.2026 (modo de bajo consumo con límite de FPS y tiempo de CPU)
+  - Modificado el 17.10.2026 (estado compacto en punto fijo)
+  - Modificado el 17.10.2026 (rotación incremental sin seno ni coseno)
+  - Modificado el 17.10.2026 (orden espacial de las estrellas)
+  - Modificado el 17.10.2026 (frames publicados en memoria compartida)
+  - Modificado el 17.10.2026 (un snapshot cargado respeta los límites de --points)
+  - Modificado el 17.10.2026 (estado compacto de 6 bytes; 8 solo al compararlo)
+  - Modificado el 17.10.2026 (--low-power ya no vuelve a ejecutar el programa)
+  - Modificado el 17.10.2026 (control de calidad solo con --target-fps y sin bajar de --points)
+  - Modificado el 17.10.2026 (--pipeline también con --backend cpu)
 */
 
 #include <SFML/Graphics.hpp>
@@ -17,34 +43,32 @@
 #include <cstdlib>
 #include <sstream>
 #include <vector>
+#include <cstdint>
 #include <random>
 #include <omp.h>
 #include <iostream>
 #include <limits>
-
-struct Star {
-    sf::ConvexShape shape;
-    float lifetime;
-};
-
-// Función para crear la forma de estrella
-sf::ConvexShape createStar(float radius, int points) {
-    sf::ConvexShape star;
-    star.setPointCount(points * 2);
-
-#pragma omp parallel for
-    for (int i = 0; i < points * 2; i++) {
-        float angle = i * 3.14159f / points;
-        float r = (i % 2 == 0) ? radius : radius / 2;
-        star.setPoint(i, sf::Vector2f(std::cos(angle) * r, std::sin(angle) * r));
-    }
-
-    star.setOrigin(radius, radius);
-    return star;
-}
-
-// Función para solicitar parámetros personalizados
-void askParameters(int &numPoints, float &maxRadius, float &speed, float &baseRotationSpeed) {
+#include <memory>
+
+#include "compact_store.h"
+#include "density.h"
+#include "frame_pipeline.h"
+#include "frame_stats.h"
+#include "galaxy.h"
+#include "incremental_rotation.h"
+#include "nbody.h"
+#include "options.h"
+#include "power.h"
+#include "quality.h"
+#include "shm_frames.h"
+#include "snapshot.h"
+#include "software_raster.h"
+#include "spatial_order.h"
+#include "star_renderer.h"
+#include "time_step.h"
+
+// Función para solicitar parámetros personalizados. Devuelve true si el usuario los eligió.
+bool askParameters(int &numPoints, float &maxRadius, float &speed, float &baseRotationSpeed) {
     char userChoice;
     std::cout << "¿Desea usar los parametros por defecto? (y/n): ";
     std::cin >> userChoice;
@@ -103,19 +127,542 @@ void askParameters(int &numPoints, float &maxRadius, float &speed, float &baseRo
     {
         printf("Preparando hilo %d de %d\n", omp_get_thread_num(), omp_get_num_threads());
     }
+    return userChoice == 'n' || userChoice == 'N';
+}
+
+// Paso de la simulación según --physics: la espiral original (un tick por paso o en forma
+// cerrada para cualquier tiempo) o la gravitación de N cuerpos. Prepara también el estado
+// inicial que necesite el modo elegido y aplica --skip-to. Si hay control de calidad, cada
+// paso aplica antes los hilos y las estrellas activas que eligió.
+SimulationStep makeSimulationStep(const Options &options, const GalaxyParams &params, StarStore &stars,
+                                  const std::shared_ptr<QualitySettings> &quality = nullptr) {
+    SimulationStep step;
+    if (options.nbody) {
+        std::shared_ptr<NBodyEngine> engine = std::make_shared<NBodyEngine>(params, options.theta, options.parallel);
+        engine->init(stars);
+        step = [engine](StarStore &state, double ticks) { engine->step(state, ticks); };
+    } else {
+        SimdLevel simd = options.simd;
+        ParallelPolicy policy = options.parallel;
+        double elapsed = 0.0; // Ticks simulados, para que las estrellas agregadas aparezcan en su lugar
+        std::shared_ptr<IncrementalRotation> incremental;
+        if (options.incrementalRotation) {
+            incremental = std::make_shared<IncrementalRotation>(simd, policy);
+        }
+        // Celdas sobre la ventana, cuyo centro es el de la galaxia
+        std::shared_ptr<SpatialOrder> order;
+        if (options.spatialOrder > 0) {
+            order = std::make_shared<SpatialOrder>(static_cast<int>(2 * params.centerX),
+                                                   static_cast<int>(2 * params.centerY), options.spatialOrder, policy);
+        }
+        step = [params, simd, policy, quality, incremental, order, elapsed](StarStore &state, double ticks) mutable {
+            int active = quality ? quality->stars.load(std::memory_order_relaxed) : 0;
+            if (active > 0 && active != static_cast<int>(state.count())) {
+                resizeGalaxy(state, params, active, elapsed, policy);
+            }
+            if (incremental) {
+                incremental->advance(state, params, ticks);
+                elapsed += ticks > 0.0 ? ticks : 1.0;
+            } else if (ticks > 0.0) {
+                advanceGalaxy(state, params, ticks, simd, policy);
+                elapsed += ticks;
+            } else {
+                updateGalaxy(state, params, simd, policy);
+                elapsed += 1.0;
+            }
+            if (order) {
+                order->maybeReorder(state);
+            }
+        };
+    }
+    if (quality) {
+        // Con --pipeline el paso corre en otro hilo, que tiene su propia cantidad de hilos de OpenMP.
+        // El pool compartido solo lo usa el paso, así que aquí no hay ningún parallelFor en curso.
+        SimulationStep inner = step;
+        bool pool = options.parallel.backend == ParallelBackend::Pool;
+        step = [inner, quality, pool](StarStore &state, double ticks) {
+            int threads = quality->threads.load(std::memory_order_relaxed);
+            if (threads > 0 && pool) {
+                WorkStealingPool::resizeShared(threads);
+            } else if (threads > 0 && threads != omp_get_max_threads()) {
+                omp_set_num_threads(threads);
+            }
+            inner(state, ticks);
+        };
+    }
+    // Con N cuerpos no hay forma cerrada: el salto se integra paso a paso
+    if (options.skipTo > 0.0f) {
+        step(stars, options.skipTo * kTicksPerSecond);
+    }
+    return step;
+}
+
+// Control de calidad para sostener fps cuadros por segundo (nullptr si fps es 0). Nunca usa
+// más estrellas de las pedidas ni menos de 5000 (el mínimo de --points). Si el usuario eligió
+// la cantidad (pointsChosen: --points, los parámetros personalizados o un snapshot) o con N
+// cuerpos, la cantidad de estrellas queda fija y solo cambian los hilos y las estrellas
+// adicionales. Con stdpar los hilos tampoco cambian: los reparte el runtime de C++.
+std::unique_ptr<QualityController> makeQualityController(const Options &options, float fps, const StarStore &stars,
+                                                         bool pointsChosen) {
+    if (fps <= 0.0f) {
+        return nullptr;
+    }
+    int maxStars = static_cast<int>(stars.count());
+    int minStars = options.nbody || pointsChosen ? maxStars : kMinPoints;
+    int threads = options.parallel.backend == ParallelBackend::Pool ? WorkStealingPool::shared().threadCount()
+                                                                     : omp_get_max_threads();
+    bool adjustThreads = options.parallel.backend != ParallelBackend::StdPar;
+    return std::unique_ptr<QualityController>(new QualityController(
+            1.0 / fps, maxStars, minStars, options.extraStarRate, threads, adjustThreads));
+}
+
+// Aplica en el hilo principal un nivel nuevo del control de calidad; las estrellas activas
+// y los hilos de la simulación los toma el siguiente paso
+void applyQuality(const QualityController &quality, QualitySettings &settings, ExtraStarPool &extraStars) {
+    quality.publish(settings);
+    extraStars.setSpawnRate(quality.spawnRate());
+    omp_set_num_threads(quality.threads());
+}
+
+// Estado inicial: cargado de un snapshot con --load (junto con sus parámetros) o generado
+bool prepareGalaxy(const Options &options, int numPoints, GalaxyParams &params, StarStore &stars) {
+    if (!options.loadPath.empty()) {
+        // Un snapshot tiene los mismos límites que --points
+        return loadSnapshot(options.loadPath, stars, params, kMinPoints,
+                            options.largeN ? static_cast<std::uint64_t>(kMaxLargePoints) : kMaxPoints);
+    }
+    stars.resize(numPoints);
+    initGalaxy(stars, params, options.parallel);
+    return true;
+}
+
+// Simular la galaxia sin ventana e imprimir los tiempos en formato CSV
+int runHeadless(const Options &options, std::uint64_t seed) {
+    // Mismo centro que la ventana de 800x800
+    GalaxyParams params;
+    params.maxRadius = options.maxRadius;
+    params.speed = options.speed;
+    params.baseRotationSpeed = options.baseRotationSpeed;
+    params.seed = seed;
+
+    StarStore stars;
+    sf::Clock clock;
+    if (!prepareGalaxy(options, options.numPoints, params, stars)) {
+        return 1;
+    }
+    std::shared_ptr<QualitySettings> qualitySettings = std::make_shared<QualitySettings>();
+    SimulationStep step = makeSimulationStep(options, params, stars, qualitySettings);
+    bool pointsChosen = options.pointsGiven || !options.loadPath.empty();
+    std::unique_ptr<QualityController> quality = makeQualityController(options, options.targetFps, stars, pointsChosen);
+    float initTime = clock.restart().asSeconds();
+    std::size_t numPoints = stars.count();   // El control de calidad puede cambiar ambos
+    int numThreads = omp_get_max_threads();
+
+    Palette palette(options.palette);
+    palette.setColorFollowsRadius(options.colorFollowsRadius, params.maxRadius);
+
+    // El lote de vértices se llena en CPU; con --render-texture además se envía a la GPU
+    // Con --large las estrellas se acumulan por densidad en una imagen en CPU
+    sf::VertexArray vertices;
+    DensityRenderer density;
+    Framebuffer densityFrame;
+    sf::RenderTexture target;
+    if (options.renderTexture && !target.create(800, 800)) {
+        std::cerr << "No se pudo crear el sf::RenderTexture\n";
+        return 1;
+    }
+
+    // Las estrellas adicionales avanzan con un paso fijo equivalente a 60 FPS
+    const float frameTime = 1.0f / 60.0f;
+    ExtraStarPool extraStars(options.extraStarRate);
+    sf::VertexArray extraVertices;
+
+    // Con --pipeline la actualización corre en su propio hilo, un frame adelante del dibujo
+    std::unique_ptr<SimulationPipeline> pipeline;
+    if (options.pipeline) {
+        pipeline.reset(new SimulationPipeline(stars, step, options.parallel));
+    }
+
+    // Percentiles por fase; con --pipeline la fase de actualización es la espera del frame
+    FrameStats stats;
+    if (!options.statsFile.empty()) {
+        stats.setDumpFile(options.statsFile, options.statsInterval);
+    }
+    SnapshotCheckpoint checkpoint(options.savePath, options.checkpointInterval);
+    const StarStore *frameStars = &stars;
+
+    // Con --fps los frames se espacian durmiendo, para medir la CPU que cuesta cada uno
+    FramePacer pacer(options.fpsLimit);
+
+    float updateTime = 0.0f;
+    float extraTime = 0.0f;
+    float renderTime = 0.0f;
+    double cpuStart = processCpuSeconds();
+    sf::Clock totalClock;
+    for (int frame = 0; frame < options.frames; ++frame) {
+        if (pipeline) {
+            frameStars = &pipeline->acquire();
+        } else {
+            step(stars, 0.0);
+        }
+        float phaseTime = clock.restart().asSeconds();
+        updateTime += phaseTime;
+        stats.record(kPhaseUpdate, phaseTime);
+        float frameSeconds = phaseTime;
+        float frameUpdate = phaseTime;
+
+        extraStars.update(frameTime, params);
+        buildExtraStarVertices(extraStars, extraVertices);
+        phaseTime = clock.restart().asSeconds();
+        extraTime += phaseTime;
+        stats.record(kPhaseExtra, phaseTime);
+        frameSeconds += phaseTime;
+
+        if (options.largeN) {
+            density.render(*frameStars, palette, densityFrame);
+        } else {
+            buildStarVertices(*frameStars, palette, vertices);
+        }
+        if (options.renderTexture && !options.largeN) {
+            target.clear(sf::Color::Black);
+            target.draw(vertices);
+            target.draw(extraVertices);
+            target.display();
+        }
+        phaseTime = clock.restart().asSeconds();
+        renderTime += phaseTime;
+        stats.record(kPhaseDraw, phaseTime);
+        stats.record(kPhaseFrame, frameSeconds + phaseTime);
+        stats.maybeDump();
+        checkpoint.maybeSave(*frameStars, params);
+
+        // Lo que escala con las estrellas es la actualización y el dibujo
+        if (quality && quality->record(frameSeconds + phaseTime, frameUpdate + phaseTime)) {
+            applyQuality(*quality, *qualitySettings, extraStars);
+        }
+        if (pacer.enabled()) {
+            stats.record(kPhaseIdle, pacer.wait());
+            clock.restart();
+        }
+    }
+    float totalTime = totalClock.getElapsedTime().asSeconds();
+    double cpuTime = processCpuSeconds() - cpuStart;
+    stats.dump();
+    if (!checkpoint.save(*frameStars, params)) {
+        return 1;
+    }
+    if (pipeline) {
+        // El tiempo de espera del hilo principal no es tiempo de actualización
+        updateTime = static_cast<float>(pipeline->updateSeconds());
+        pipeline.reset();
+    }
+
+    std::cout << "version,hilos,simd,puntos,radio_max,velocidad,rotacion,semilla,frames,"
+                 "init_s,update_s,update_ms_por_frame,extra_s,extra_ms_por_frame,"
+                 "render,render_s,render_ms_por_frame,pipeline,total_s,frames_por_s,paralelo,chunk,fisica,"
+                 "fps_objetivo,estrellas_activas,hilos_activos,fps_limite,cpu_s,cpu_ms_por_frame,rotacion_incremental,orden_espacial\n";
+    std::cout << "omp," << numThreads << ',' << simdLevelName(resolveSimdLevel(options.simd)) << ','
+              << numPoints << ','
+              << params.maxRadius << ',' << params.speed << ',' << params.baseRotationSpeed << ','
+              << params.seed << ','
+              << options.frames << ',' << initTime << ',' << updateTime << ','
+              << 1000.0f * updateTime / options.frames << ','
+              << extraTime << ',' << 1000.0f * extraTime / options.frames << ','
+              << (options.largeN ? "densidad" : (options.renderTexture ? "render_texture" : "cpu")) << ','
+              << renderTime << ','
+              << 1000.0f * renderTime / options.frames << ','
+              << (options.pipeline ? 1 : 0) << ',' << totalTime << ','
+              << options.frames / totalTime << ',' << parallelBackendName(options.parallel.backend) << ','
+              << options.parallel.chunk << ',' << (options.nbody ? "nbody" : "espiral") << ','
+              << std::max(options.targetFps, 0.0f) << ',' << (quality ? quality->stars() : stars.count()) << ','
+              << omp_get_max_threads() << ',' << options.fpsLimit << ',' << cpuTime << ','
+              << 1000.0 * cpuTime / options.frames << ',' << (options.incrementalRotation ? 1 : 0) << ','
+              << options.spatialOrder << std::endl;
+    return 0;
+}
+
+// Dibujar la galaxia en CPU sin ventana, opcionalmente guardando cada frame
+int runSoftware(const Options &options, std::uint64_t seed) {
+    GalaxyParams params;
+    params.maxRadius = options.maxRadius;
+    params.speed = options.speed;
+    params.baseRotationSpeed = options.baseRotationSpeed;
+    params.seed = seed;
+
+    StarStore stars;
+    if (!prepareGalaxy(options, options.numPoints, params, stars)) {
+        return 1;
+    }
+    SimulationStep step = makeSimulationStep(options, params, stars);
+
+    Palette palette(options.palette);
+    palette.setColorFollowsRadius(options.colorFollowsRadius, params.maxRadius);
+    ExtraStarPool extraStars(options.extraStarRate);
+    TiledRasterizer rasterizer(800, 800, options.tileSize);
+    DensityRenderer density;
+    Framebuffer frame;
+
+    SnapshotCheckpoint checkpoint(options.savePath, options.checkpointInterval);
+    FrameWriter writer;
+    if (!options.outputPattern.empty() && !writer.openSequence(options.outputPattern)) {
+        return 1;
+    }
+    if (!options.rawOutput.empty() && !writer.openRaw(options.rawOutput)) {
+        std::cerr << "No se pudo abrir " << options.rawOutput << "\n";
+        return 1;
+    }
+    ShmFrameProducer shm;
+    if (!options.shmName.empty() && !shm.open(options.shmName, 800, 800, options.shmSlots)) {
+        return 1;
+    }
+    // Con --fps un lector en vivo recibe los frames al ritmo de la ventana
+    FramePacer pacer(options.fpsLimit);
+
+    // Con --pipeline el frame N+1 se simula mientras se dibuja y escribe el N; la fase de
+    // actualización es entonces la espera del frame
+    std::unique_ptr<SimulationPipeline> pipeline;
+    if (options.pipeline) {
+        pipeline.reset(new SimulationPipeline(stars, step, options.parallel));
+    }
+    const StarStore *frameStars = &stars;
+
+    // Paso fijo equivalente a 60 FPS: el video resultante tiene la misma velocidad que la ventana
+    const float frameTime = 1.0f / 60.0f;
+    float updateTime = 0.0f;
+    float rasterTime = 0.0f;
+    float writeTime = 0.0f;
+    sf::Clock clock;
+    sf::Clock totalClock;
+    for (int f = 0; f < options.frames; ++f) {
+        if (pipeline) {
+            frameStars = &pipeline->acquire();
+        } else {
+            step(stars, 0.0);
+        }
+        extraStars.update(frameTime, params);
+        updateTime += clock.restart().asSeconds();
+
+        if (options.largeN) {
+            density.render(*frameStars, palette, frame);
+            density.drawExtraStars(extraStars, frame);
+        } else {
+            rasterizer.render(*frameStars, palette, extraStars, frame);
+        }
+        rasterTime += clock.restart().asSeconds();
+
+        if (!writer.write(frame)) {
+            std::cerr << "Error al escribir el frame " << f << "\n";
+            return 1;
+        }
+        if (shm.isOpen()) {
+            shm.publish(frame);
+        }
+        writeTime += clock.restart().asSeconds();
+        checkpoint.maybeSave(*frameStars, params);
+        pacer.wait();
+        clock.restart();
+    }
+    float totalTime = totalClock.getElapsedTime().asSeconds();
+    if (!checkpoint.save(*frameStars, params)) {
+        return 1;
+    }
+    pipeline.reset();
+
+    // Si los frames van a stdout el reporte se escribe en stderr
+    std::ostream &report = writer.writesToStdout() ? std::cerr : std::cout;
+    report << "version,hilos,puntos,frames,mosaico,update_s,raster_s,raster_ms_por_frame,"
+              "escritura_s,total_s,frames_por_s,shm_publicados,shm_leidos,shm_perdidos\n";
+    report << "omp_cpu," << omp_get_max_threads() << ',' << stars.count() << ',' << options.frames << ','
+           << options.tileSize << ',' << updateTime << ',' << rasterTime << ','
+           << 1000.0f * rasterTime / options.frames << ',' << writeTime << ',' << totalTime << ','
+           << options.frames / totalTime << ',' << shm.published() << ',' << shm.consumed() << ','
+           << shm.consumerDropped() << std::endl;
+    return 0;
 }
 
-int main() {
-    // Parámetros por defecto de la galaxia
-    int numPoints = 15000;             // Número de puntos en la galaxia
-    float maxRadius = 450.0f;          // Radio máximo de la galaxia
-    const float angleIncrement = 0.70f; // Incremento de ángulo para los brazos espirales
-    float speed = 0.035f;              // Velocidad de los puntos moviéndose hacia el centro
-    float baseRotationSpeed = 0.0007f; // Velocidad base de la rotación de la galaxia
-    const int numArms = 5;             // Número de brazos espirales
+// Simular con el estado compacto (--compact): sin ventana, midiendo los tiempos y, con
+// --backend cpu, guardando los frames igual que runSoftware
+int runCompact(const Options &options, std::uint64_t seed) {
+    GalaxyParams params;
+    params.maxRadius = options.maxRadius;
+    params.speed = options.speed;
+    params.baseRotationSpeed = options.baseRotationSpeed;
+    params.seed = seed;
+
+    sf::Clock clock;
+    CompactGalaxy galaxy;
+    galaxy.init(options.numPoints, params, options.parallel);
+    galaxy.advance(options.skipTo * kTicksPerSecond, options.parallel);
+    float initTime = clock.restart().asSeconds();
+
+    Palette palette(options.palette);
+    palette.setColorFollowsRadius(options.colorFollowsRadius, params.maxRadius);
+    ExtraStarPool extraStars(options.extraStarRate);
+    DensityRenderer density;
+    Framebuffer frame;
+
+    FrameWriter writer;
+    if (options.cpuBackend && !options.outputPattern.empty() && !writer.openSequence(options.outputPattern)) {
+        return 1;
+    }
+    if (options.cpuBackend && !options.rawOutput.empty() && !writer.openRaw(options.rawOutput)) {
+        std::cerr << "No se pudo abrir " << options.rawOutput << "\n";
+        return 1;
+    }
+    ShmFrameProducer shm;
+    if (!options.shmName.empty() && !shm.open(options.shmName, 800, 800, options.shmSlots)) {
+        return 1;
+    }
+    FramePacer pacer(options.fpsLimit);
+
+    // Un tick por frame, como en los demás modos sin ventana
+    const float frameTime = 1.0f / 60.0f;
+    float updateTime = 0.0f;
+    float renderTime = 0.0f;
+    float writeTime = 0.0f;
+    sf::Clock totalClock;
+    for (int f = 0; f < options.frames; ++f) {
+        galaxy.advance(1.0, options.parallel);
+        extraStars.update(frameTime, params);
+        updateTime += clock.restart().asSeconds();
+
+        density.render(galaxy, palette, frame);
+        if (options.cpuBackend) {
+            density.drawExtraStars(extraStars, frame);
+        }
+        renderTime += clock.restart().asSeconds();
+
+        if (options.cpuBackend && !writer.write(frame)) {
+            std::cerr << "Error al escribir el frame " << f << "\n";
+            return 1;
+        }
+        if (shm.isOpen()) {
+            shm.publish(frame);
+        }
+        writeTime += clock.restart().asSeconds();
+        pacer.wait();
+        clock.restart();
+    }
+    float totalTime = totalClock.getElapsedTime().asSeconds();
+
+    std::ostream &report = writer.writesToStdout() ? std::cerr : std::cout;
+    report << "version,hilos,puntos,bytes_por_estrella,frames,init_s,update_s,update_ms_por_frame,"
+              "render_s,render_ms_por_frame,escritura_s,total_s,frames_por_s,shm_publicados,shm_leidos,shm_perdidos\n";
+    report << "omp_compacto," << omp_get_max_threads() << ',' << galaxy.count() << ','
+           << galaxy.bytesPerStar() << ',' << options.frames << ',' << initTime << ',' << updateTime << ','
+           << 1000.0f * updateTime / options.frames << ',' << renderTime << ','
+           << 1000.0f * renderTime / options.frames << ',' << writeTime << ',' << totalTime << ','
+           << options.frames / totalTime << ',' << shm.published() << ',' << shm.consumed() << ','
+           << shm.consumerDropped() << std::endl;
+    return 0;
+}
+
+// Avanzar a la vez el estado compacto y el de punto flotante (--compact-check) y comparar las
+// posiciones con la cota de error del formato. Las estrellas que reaparecieron en frames
+// distintos en cada estado (por estar justo en el centro) no se comparan.
+int checkCompact(const Options &options, std::uint64_t seed) {
+    GalaxyParams params;
+    params.maxRadius = options.maxRadius;
+    params.speed = options.speed;
+    params.baseRotationSpeed = options.baseRotationSpeed;
+    params.seed = seed;
+
+    StarStore stars;
+    stars.resize(options.numPoints);
+    initGalaxy(stars, params, options.parallel);
+    // Con la generación completa, para que los sorteos coincidan con los del estado en punto flotante
+    CompactGalaxy galaxy;
+    galaxy.init(options.numPoints, params, options.parallel, true);
+
+    double skipTicks = options.skipTo * kTicksPerSecond;
+    advanceGalaxy(stars, params, skipTicks, options.simd, options.parallel);
+    galaxy.advance(skipTicks, options.parallel);
+
+    double maxError = 0.0;
+    double sumError = 0.0;
+    long long compared = 0;
+    long long skipped = 0;
+    int checks = 10; // Se compara unas 10 veces a lo largo de la simulación
+    for (int f = 0; f <= options.frames; ++f) {
+        if (f > 0) {
+            advanceGalaxy(stars, params, 1.0, options.simd, options.parallel);
+            galaxy.advance(1.0, options.parallel);
+        }
+        if (f % std::max(1, options.frames / checks) != 0 && f != options.frames) {
+            continue;
+        }
+        CompactGalaxy::Decoder decoder = galaxy.decoder();
+        int numPoints = static_cast<int>(stars.count());
+#pragma omp parallel for reduction(max:maxError) reduction(+:sumError, compared, skipped)
+        for (int i = 0; i < numPoints; ++i) {
+            if (stars.generation[i] != galaxy.generation(i)) {
+                ++skipped;
+                continue;
+            }
+            float x, y, radius, size;
+            std::uint16_t index;
+            galaxy.decode(decoder, i, x, y, radius, size, index);
+            double error = std::hypot(static_cast<double>(x) - stars.x[i], static_cast<double>(y) - stars.y[i]);
+            maxError = std::max(maxError, error);
+            sumError += error;
+            ++compared;
+        }
+    }
+
+    bool ok = maxError <= galaxy.errorBound();
+    std::cout << "puntos,ticks,bytes_float,bytes_compacto,error_max_px,error_medio_px,cota_px,comparadas,"
+                 "omitidas,resultado\n";
+    std::cout << stars.count() << ',' << skipTicks + options.frames << ',' << StarStore::bytesPerStar() << ','
+              << galaxy.bytesPerStar() << ',' << maxError << ',' << sumError / std::max(compared, 1LL)
+              << ',' << galaxy.errorBound() << ',' << compared << ',' << skipped << ','
+              << (ok ? "ok" : "fuera_de_cota") << std::endl;
+    return ok ? 0 : 1;
+}
+
+int main(int argc, char **argv) {
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        return 1;
+    }
+
+    // Con --low-power los hilos duermen entre frames en lugar de girar esperando
+    if (options.lowPower) {
+        requestPassiveWait();
+    }
+
+    // Parámetros de la galaxia
+    int numPoints = options.numPoints;                 // Número de puntos en la galaxia
+    float maxRadius = options.maxRadius;               // Radio máximo de la galaxia
+    float speed = options.speed;                       // Velocidad de los puntos moviéndose hacia el centro
+    float baseRotationSpeed = options.baseRotationSpeed; // Velocidad base de la rotación de la galaxia
+
+    if (options.threads > 0) {
+        omp_set_num_threads(options.threads);
+    }
+
+    // Semilla de los números aleatorios: con la misma semilla la galaxia es idéntica
+    // sin importar la cantidad de hilos
+    std::random_device rd;
+    std::uint64_t seed = options.hasSeed ? options.seed : rd();
+
+    if (options.compactCheck) {
+        return checkCompact(options, seed);
+    }
+    if (options.compact) {
+        return runCompact(options, seed);
+    }
+    if (options.cpuBackend) {
+        return runSoftware(options, seed);
+    }
+    if (options.headless) {
+        return runHeadless(options, seed);
+    }
 
     // Solicitar los parámetros al usuario
-    askParameters(numPoints, maxRadius, speed, baseRotationSpeed);
+    bool pointsChosen = options.pointsGiven || !options.loadPath.empty();
+    if (options.interactive && askParameters(numPoints, maxRadius, speed, baseRotationSpeed)) {
+        pointsChosen = true;
+    }
 
     // Crear la ventana
     sf::RenderWindow window(sf::VideoMode(800, 800), "Spiral Galaxy");
@@ -123,8 +670,34 @@ int main() {
     // Centro de la ventana
     sf::Vector2f center(window.getSize().x / 2.0f, window.getSize().y / 2.0f);
 
-    // Vector para almacenar todos los puntos de la galaxia
-    std::vector<sf::CircleShape> points(numPoints);
+    // Estado de la galaxia (estructura de arreglos en coordenadas polares)
+    GalaxyParams params;
+    params.centerX = center.x;
+    params.centerY = center.y;
+    params.maxRadius = maxRadius;
+    params.speed = speed;
+    params.baseRotationSpeed = baseRotationSpeed;
+    params.seed = seed;
+
+    StarStore stars;
+    if (!prepareGalaxy(options, numPoints, params, stars)) {
+        return -1;
+    }
+
+    // Lote de vértices con todas las estrellas y su paleta de colores
+    sf::VertexArray starVertices;
+    Palette palette(options.palette);
+
+    // Con --large la galaxia se acumula por densidad en CPU y se muestra como una textura
+    DensityRenderer density;
+    Framebuffer densityFrame;
+    std::vector<sf::Uint8> densityPixels;
+    sf::Texture densityTexture;
+    if (options.largeN && !densityTexture.create(window.getSize().x, window.getSize().y)) {
+        return -1;
+    }
+    sf::Sprite densitySprite(densityTexture);
+    palette.setColorFollowsRadius(options.colorFollowsRadius, params.maxRadius);
 
     // Fuente para el contador de FPS
     sf::Font font;
@@ -140,178 +713,129 @@ int main() {
 
     // Reloj para medir el tiempo entre cuadros
     sf::Clock clock;
-    std::vector<float> frameTimes; // Almacenar los tiempos de frame
+    FrameStats stats; // Histogramas de tiempo por fase, de memoria fija
+    if (!options.statsFile.empty()) {
+        stats.setDumpFile(options.statsFile, options.statsInterval);
+    }
 
-    // Vector para almacenar las estrellas adicionales
-    std::vector<Star> extraStars;
-    sf::Clock starClock;
+    // Estrellas adicionales en un búfer circular de capacidad fija
+    ExtraStarPool extraStars(options.extraStarRate);
+    sf::VertexArray extraVertices;
+
+    // Control de calidad, solo con --target-fps: a lo más numPoints estrellas
+    std::shared_ptr<QualitySettings> qualitySettings = std::make_shared<QualitySettings>();
+    SimulationStep step = makeSimulationStep(options, params, stars, qualitySettings);
+    std::unique_ptr<QualityController> quality =
+            makeQualityController(options, options.targetFps, stars, pointsChosen);
+    SnapshotCheckpoint checkpoint(options.savePath, options.checkpointInterval);
+
+    std::unique_ptr<SimulationPipeline> pipeline;
+    const StarStore *pipelineFrame = nullptr;
+    if (options.pipeline) {
+        pipeline.reset(new SimulationPipeline(stars, step, options.parallel));
+    }
 
-    // Generador de números aleatorios
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_real_distribution<> dis(0, 1);
-
-    // Generar los puntos en la galaxia (como círculos)
-#pragma omp parallel for
-    for (int i = 0; i < numPoints; ++i) {
-        float angleOffset = dis(gen) * 2 * 3.14159f;
-        float armAngle = (i * angleIncrement) + (2 * 3.14159f / numArms) * (rand() % numArms) + angleOffset * 0.5f;
-
-        float radius = maxRadius * std::sqrt(dis(gen)) * (0.9f + 0.2f * dis(gen));
-        float x = center.x + radius * std::cos(armAngle);
-        float y = center.y + radius * std::sin(armAngle);
-
-        // Crear un punto con un radio de 1 o 2 píxeles (círculos)
-        sf::CircleShape star((rand() % 10) < 3 ? 2.0f : 1.0f);
-        star.setPosition(x, y);
-
-        // Determinar el color basado en la distancia desde el centro
-        sf::Color color;
-        float normalizedRadius = radius / maxRadius;
-        if (normalizedRadius < 0.3f) {
-            color = sf::Color(200, 200, 100 + static_cast<sf::Uint8>(55 * normalizedRadius / 0.3f));
-        } else if (normalizedRadius < 0.7f) {
-            color = sf::Color(static_cast<sf::Uint8>(100 * (1 - (normalizedRadius - 0.3f) / 0.4f)),
-                              static_cast<sf::Uint8>(100 + 55 * (normalizedRadius - 0.3f) / 0.4f), 200);
-        } else {
-            color = sf::Color(80 + static_cast<sf::Uint8>(127 * (normalizedRadius - 0.7f) / 0.3f), 0, 180);
-        }
-        star.setFillColor(color);
+    // La galaxia avanza según el tiempo real y no según la cantidad de frames. Con --sim-hz
+    // avanza en pasos fijos; si un frame tarda más, los pasos pendientes se dan de una vez.
+    double simStep = options.simHz > 0.0f ? 1.0 / options.simHz : 0.0;
+    double simPending = 0.0; // Segundos aún no simulados
 
-        points[i] = star;
-    }
+    // Con --fps o --low-power se duerme hasta el siguiente frame en lugar de dibujar sin parar
+    FramePacer pacer(options.fpsLimit);
+    double cpuStart = processCpuSeconds();
 
     // Bucle principal
+    clock.restart();
+    stats.startLap();
     while (window.isOpen()) {
         sf::Event event;
         while (window.pollEvent(event)) {
             if (event.type == sf::Event::Closed)
                 window.close();
+            // Cambiar de paleta con la tecla P
+            if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::P)
+                palette.cycle();
         }
+        double workTime = stats.lap(kPhaseEvents);
 
         float currentTime = clock.restart().asSeconds();
-        frameTimes.push_back(currentTime); // Almacenar el tiempo de cada frame
+        stats.record(kPhaseFrame, currentTime); // Tiempo de cada frame
         float fps = 1.0f / currentTime;
 
         // Actualizar el contador de FPS
         std::stringstream ss;
         ss << "FPS: " << static_cast<int>(fps);
+        if (quality) {
+            ss << "  Estrellas: " << quality->stars();
+        }
         fpsText.setString(ss.str());
 
         window.clear(sf::Color::Black);
 
-        // Actualizar la posición de los puntos de la galaxia
-#pragma omp parallel for
-        for (int i = 0; i < numPoints; ++i) {
-            sf::Vector2f pos = points[i].getPosition();
-            float dx = pos.x - center.x;
-            float dy = pos.y - center.y;
-
-            float angle = std::atan2(dy, dx);
-            float radius = std::sqrt(dx * dx + dy * dy);
-
-            float rotationSpeed = baseRotationSpeed * (1.0f + (maxRadius - radius) / maxRadius);
-            angle += rotationSpeed;
-
-            float attractionSpeed = speed * (1.0f + (maxRadius - radius) / maxRadius);
-            radius -= attractionSpeed;
-
-            if (radius < 0) {
-                radius = maxRadius;
-
-                // Añadir alguna variación aleatoria al ángulo y radio
-                angle += static_cast<float>(rand()) / RAND_MAX * 0.2f - 0.1f;
-                radius *= 0.9f + static_cast<float>(rand()) / RAND_MAX * 0.2f;
-
-                // Establecer un nuevo color para el punto basado en la distancia
-                float normalizedRadius = radius / maxRadius;
-                sf::Color newColor;
-
-                // Usar un ciclo para cambiar los colores de forma continua
-                if (normalizedRadius < 0.3f) {
-                    // Amarillo oscuro hacia el centro
-                    newColor = sf::Color(200, 200, 100 + static_cast<sf::Uint8>(55 * normalizedRadius / 0.3f));
-                } else if (normalizedRadius < 0.7f) {
-                    // Azul oscuro en la zona media
-                    newColor = sf::Color(
-                        static_cast<sf::Uint8>(100 * (1 - (normalizedRadius - 0.3f) / 0.4f)),
-                        static_cast<sf::Uint8>(100 + 55 * (normalizedRadius - 0.3f) / 0.4f),
-                        200);
-                } else {
-                    // Volver al color amarillo para continuar el ciclo en lugar de quedarse en violeta
-                    float cycleRadius = fmod(normalizedRadius - 0.7f, 1.0f);  // Usar fmod para reiniciar el ciclo
-                    if (cycleRadius < 0.3f) {
-                        newColor = sf::Color(200, 200, 100 + static_cast<sf::Uint8>(55 * cycleRadius / 0.3f));
-                    } else if (cycleRadius < 0.7f) {
-                        newColor = sf::Color(
-                            static_cast<sf::Uint8>(100 * (1 - (cycleRadius - 0.3f) / 0.4f)),
-                            static_cast<sf::Uint8>(100 + 55 * (cycleRadius - 0.3f) / 0.4f),
-                            200);
-                    } else {
-                        newColor = sf::Color(80 + static_cast<sf::Uint8>(127 * (cycleRadius - 0.7f) / 0.3f), 0, 180);
-                    }
-                }
-
-                points[i].setFillColor(newColor);
-            }
-
-
-            float x = center.x + radius * std::cos(angle);
-            float y = center.y + radius * std::sin(angle);
-
-            points[i].setPosition(x, y);
-        }
+        simPending += currentTime;
+        double stepSeconds = simStep > 0.0 ? std::floor(simPending / simStep) * simStep : simPending;
+        simPending -= stepSeconds;
 
-#pragma omp barrier // Asegurar que todas las posiciones se calculen antes de dibujar
-
-        // Dibujar los puntos de la galaxia
-        for (int i = 0; i < numPoints; ++i) {
-            window.draw(points[i]);
+        // Con --pipeline este frame ya se calculó mientras se dibujaba el anterior; el tiempo
+        // que se pide ahora se aplica al paso que empieza a calcularse al tomarlo
+        const StarStore *frameStars = &stars;
+        if (pipeline) {
+            if (stepSeconds > 0.0) {
+                pipeline->setStepTicks(stepSeconds * kTicksPerSecond);
+            }
+            if (stepSeconds > 0.0 || !pipelineFrame) {
+                pipelineFrame = &pipeline->acquire();
+            }
+            frameStars = pipelineFrame;
+        } else if (stepSeconds > 0.0) {
+            step(stars, stepSeconds * kTicksPerSecond);
         }
+        double starTime = stats.lap(kPhaseUpdate);
 
-        // Generar estrellas adicionales al azar
-        if (starClock.getElapsedTime().asSeconds() > 0.1f) {
-            Star newStar;
-            float starRadius = dis(gen) * maxRadius;
-            float starAngle = dis(gen) * 2 * 3.14159f;
-            newStar.shape = createStar(6.0f, 5); // Crear una estrella más grande
-            newStar.shape.setPosition(
-                center.x + starRadius * std::cos(starAngle),
-                center.y + starRadius * std::sin(starAngle)
-            );
-            newStar.shape.setFillColor(sf::Color(255, 255, 255, 255)); // Opacidad inicial completa
-            newStar.lifetime = 1.5f; // Tiempo de vida de la estrella en segundos
-            extraStars.push_back(newStar);
-            starClock.restart();
+        // Dibujar los puntos de la galaxia con una sola llamada
+        if (options.largeN) {
+            density.render(*frameStars, palette, densityFrame);
+            uploadFramebuffer(densityFrame, densityTexture, densityPixels);
+            window.draw(densitySprite);
+        } else {
+            buildStarVertices(*frameStars, palette, starVertices);
+            window.draw(starVertices);
         }
+        starTime += stats.lap(kPhaseDraw);
 
-        // Dibujar y actualizar las estrellas adicionales
-        for (size_t i = 0; i < extraStars.size();) {
-            Star& star = extraStars[i];
-            window.draw(star.shape);
-            star.lifetime -= currentTime;
-            if (star.lifetime <= 0.0f) {
-                extraStars.erase(extraStars.begin() + i);
-            } else {
-                float alpha = static_cast<sf::Uint8>(255 * (star.lifetime / 1.5f)); // Ajustar opacidad basada en el tiempo de vida
-                star.shape.setFillColor(sf::Color(255, 255, 255, alpha));
-                ++i;
-            }
-        }
+        // Generar, desvanecer y dibujar las estrellas adicionales en un solo lote
+        extraStars.update(currentTime, params);
+        buildExtraStarVertices(extraStars, extraVertices);
+        window.draw(extraVertices);
+        workTime += starTime + stats.lap(kPhaseExtra);
 
         window.draw(fpsText); // Dibujar el contador de FPS
 
         window.display(); // Mostrar la ventana
-    }
+        stats.lap(kPhaseDisplay);
+        stats.maybeDump();
+        checkpoint.maybeSave(*frameStars, params);
 
-    // Cálculo del tiempo promedio por frame
-    float totalFrameTime = 0.0f;
-    for (const auto& time : frameTimes) {
-        totalFrameTime += time;
+        // La espera del display (sincronía vertical) no cuenta como costo del frame
+        if (quality && quality->record(workTime, starTime)) {
+            applyQuality(*quality, *qualitySettings, extraStars);
+        }
+        if (pacer.enabled()) {
+            pacer.wait();
+            stats.lap(kPhaseIdle);
+        }
     }
 
-    float avgFrameTime = totalFrameTime / frameTimes.size();
+    // Con --save el estado final queda guardado para retomarlo con --load
+    checkpoint.save(pipelineFrame ? *pipelineFrame : stars, params);
+
+    // Tiempo promedio por frame y percentiles de cada fase
+    float avgFrameTime = static_cast<float>(stats.phase(kPhaseFrame).mean());
     std::cout << "Tiempo promedio por frame: " << avgFrameTime << " segundos" << std::endl;
+    double frames = static_cast<double>(std::max<std::uint64_t>(stats.phase(kPhaseFrame).count(), 1));
+    std::cout << "Tiempo de CPU por frame: " << (processCpuSeconds() - cpuStart) / frames << " segundos" << std::endl;
+    stats.printSummary(std::cout);
+    stats.dump();
 
     return 0;
 }
@@ -0,0 +1,399 @@
+/*
+* Nombre: nbody.h
+* Autores:
+  - Andrés Montoya, 21552
+  - Fernanda Esquivel, 21542
+  - Francisco Castillo, 21562
+* Descripción: Modo gravitacional de N cuerpos con un árbol cuaternario de Barnes–Hut (OpenMP).
+* Lenguaje: C++
+* Recursos: CLion
+* Historial:
+  - Creado el 17.10.2026
+  - Modificado el 17.10.2026 (la fuerza de una estrella que reaparece se calcula al reaparecer)
+*/
+
+#ifndef PARALLEL_SCREENSAVER_NBODY_H
+#define PARALLEL_SCREENSAVER_NBODY_H
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <omp.h>
+
+#include "galaxy.h"
+#include "parallel_backend.h"
+#include "star_store.h"
+#include "star_update.h"
+
+#ifdef GALAXY_HAS_STD_PARALLEL
+#include <execution>
+#endif
+
+// Las estrellas se atraen entre sí y hacia una masa central. Las fuerzas se aproximan con
+// Barnes–Hut: un grupo de estrellas lejano (tamaño / distancia < theta) actúa como una sola
+// masa en su centro de masa, así que cada paso cuesta O(N log N) en lugar de O(N²).
+// Las posiciones son stars.x/y (las mismas que calcula la espiral) y el tiempo se mide en
+// ticks; después de cada paso se recalculan el radio y el ángulo, y las estrellas que caen
+// al centro o escapan reaparecen en el borde con respawnStar.
+class NBodyEngine {
+public:
+    explicit NBodyEngine(const GalaxyParams &params, float theta = 0.5f,
+                         const ParallelPolicy &policy = ParallelPolicy())
+        : params_(params), theta_(theta), policy_(policy) {
+        // La velocidad angular en el borde es la rotación base de la espiral; de la masa que
+        // la sostiene, una parte está en el centro y el resto repartida entre las estrellas
+        double omega = params.baseRotationSpeed;
+        double totalGM = omega * omega * params.maxRadius * params.maxRadius * params.maxRadius;
+        centralGM_ = static_cast<float>(totalGM * (1.0 - kStarMassFraction));
+        starsGM_ = static_cast<float>(totalGM * kStarMassFraction);
+    }
+
+    float theta() const {
+        return theta_;
+    }
+
+    // Velocidades circulares para la galaxia recién generada
+    void init(StarStore &stars) {
+        int numPoints = static_cast<int>(stars.count());
+        resize(numPoints);
+        parallelFor(policy_, 0, blockCount(numPoints), [&](int block) {
+            for (int i = blockBegin(block); i < blockEnd(block, numPoints); ++i) {
+                setCircularVelocity(stars, i);
+                ax_[i] = 0.0f;
+                ay_[i] = 0.0f;
+            }
+        });
+        accelerationValid_ = false;
+    }
+
+    // Avanza la simulación (0 = un tick, como un paso del ciclo original). Los pasos largos se
+    // dividen en subpasos de a lo más un tick para que el integrador siga siendo estable.
+    void step(StarStore &stars, double ticks) {
+        if (static_cast<int>(vx_.size()) != static_cast<int>(stars.count())) {
+            init(stars);
+        }
+        if (ticks <= 0.0) {
+            ticks = 1.0;
+        }
+        int substeps = static_cast<int>(std::ceil(ticks / kMaxStepTicks));
+        float dt = static_cast<float>(ticks / substeps);
+        int numPoints = static_cast<int>(stars.count());
+
+        if (!accelerationValid_) {
+            computeForces(stars);
+        }
+        // Salto de rana (patada, deriva, patada): simpléctico, conserva la energía a largo plazo
+        for (int s = 0; s < substeps; ++s) {
+            parallelFor(policy_, 0, blockCount(numPoints), [&](int block) {
+                for (int i = blockBegin(block); i < blockEnd(block, numPoints); ++i) {
+                    vx_[i] += 0.5f * dt * ax_[i];
+                    vy_[i] += 0.5f * dt * ay_[i];
+                    stars.x[i] += dt * vx_[i];
+                    stars.y[i] += dt * vy_[i];
+                }
+            });
+            computeForces(stars);
+            parallelFor(policy_, 0, blockCount(numPoints), [&](int block) {
+                for (int i = blockBegin(block); i < blockEnd(block, numPoints); ++i) {
+                    vx_[i] += 0.5f * dt * ax_[i];
+                    vy_[i] += 0.5f * dt * ay_[i];
+                }
+            });
+        }
+        writeBackPolar(stars);
+    }
+
+    // Energía total (cinética + potencial exacta en O(N²)); solo para verificar el integrador
+    double totalEnergy(const StarStore &stars) const {
+        int numPoints = static_cast<int>(stars.count());
+        double starGM = starsGM_ / numPoints;
+        double eps2 = kSoftening * kSoftening;
+        double energy = 0.0;
+#pragma omp parallel for reduction(+ : energy) schedule(dynamic, 64)
+        for (int i = 0; i < numPoints; ++i) {
+            double dx = stars.x[i] - params_.centerX, dy = stars.y[i] - params_.centerY;
+            energy += 0.5 * (vx_[i] * vx_[i] + vy_[i] * vy_[i]) - centralGM_ / std::sqrt(dx * dx + dy * dy + eps2);
+            for (int j = i + 1; j < numPoints; ++j) {
+                double ex = stars.x[j] - stars.x[i], ey = stars.y[j] - stars.y[i];
+                energy -= starGM / std::sqrt(ex * ex + ey * ey + eps2);
+            }
+        }
+        return energy; // Por unidad de masa de una estrella
+    }
+
+private:
+    static constexpr double kStarMassFraction = 0.2; // Parte de la masa que está en las estrellas
+    static constexpr float kSoftening = 2.0f;        // Suavizado en píxeles para los encuentros cercanos
+    static constexpr double kMaxStepTicks = 1.0;
+    static const int kLeafSize = 8;                  // Estrellas por hoja del árbol
+    static const int kMaxDepth = 16;                 // 16 bits por eje en el código de Morton
+    static const int kTaskSize = 4096;               // Subárboles más grandes se construyen en otra tarea
+
+    struct Node {
+        float comX, comY;  // Centro de masa
+        float mass;        // GM del grupo
+        float width;       // Lado de la celda
+        int child;         // Primero de los 4 hijos consecutivos, o -1 si es hoja
+        int begin, end;    // Estrellas de la celda en el orden de Morton
+    };
+
+    static int blockCount(int numPoints) {
+        return (numPoints + kUpdateBlock - 1) / kUpdateBlock;
+    }
+
+    static int blockBegin(int block) {
+        return block * kUpdateBlock;
+    }
+
+    static int blockEnd(int block, int numPoints) {
+        return std::min(numPoints, (block + 1) * kUpdateBlock);
+    }
+
+    void resize(int numPoints) {
+        vx_.resize(numPoints);
+        vy_.resize(numPoints);
+        ax_.resize(numPoints);
+        ay_.resize(numPoints);
+        keys_.resize(numPoints);
+        sortedX_.resize(numPoints);
+        sortedY_.resize(numPoints);
+        // Cada nodo interno tiene más de kLeafSize estrellas, así que en cada nivel hay a lo
+        // más N / (kLeafSize + 1) de ellos, y cada uno reserva 4 hijos. Las páginas que no se
+        // usan nunca se tocan.
+        std::size_t internal = static_cast<std::size_t>(kMaxDepth) * (numPoints / (kLeafSize + 1) + 1);
+        nodes_.resize(1 + 4 * internal);
+    }
+
+    // Masa encerrada suponiendo densidad superficial uniforme, como la genera initGalaxy
+    float enclosedGM(float radius) const {
+        float fraction = std::min(radius / params_.maxRadius, 1.0f);
+        return centralGM_ + starsGM_ * fraction * fraction;
+    }
+
+    void setCircularVelocity(const StarStore &stars, int i) {
+        float dx = stars.x[i] - params_.centerX;
+        float dy = stars.y[i] - params_.centerY;
+        float r2 = dx * dx + dy * dy + kSoftening * kSoftening;
+        float r = std::sqrt(r2);
+        // En órbita circular v² / r = GM / r² (con el mismo suavizado que la fuerza)
+        float speed = std::sqrt(enclosedGM(r) * (dx * dx + dy * dy) / (r2 * r));
+        float invR = 1.0f / r;
+        // Sentido del ángulo creciente, igual que la espiral
+        vx_[i] = -dy * invR * speed;
+        vy_[i] = dx * invR * speed;
+    }
+
+    static std::uint32_t spreadBits(std::uint32_t v) {
+        v &= 0xffff;
+        v = (v | (v << 8)) & 0x00ff00ff;
+        v = (v | (v << 4)) & 0x0f0f0f0f;
+        v = (v | (v << 2)) & 0x33333333;
+        v = (v | (v << 1)) & 0x55555555;
+        return v;
+    }
+
+    // Construye el árbol: ordena las estrellas por código de Morton y parte cada celda en
+    // los 4 rangos contiguos de sus cuadrantes, con una tarea de OpenMP por subárbol grande
+    void buildTree(const StarStore &stars) {
+        int numPoints = static_cast<int>(stars.count());
+        float minX = stars.x[0], maxX = stars.x[0], minY = stars.y[0], maxY = stars.y[0];
+#pragma omp parallel for reduction(min : minX, minY) reduction(max : maxX, maxY)
+        for (int i = 0; i < numPoints; ++i) {
+            minX = std::min(minX, stars.x[i]);
+            maxX = std::max(maxX, stars.x[i]);
+            minY = std::min(minY, stars.y[i]);
+            maxY = std::max(maxY, stars.y[i]);
+        }
+        rootWidth_ = std::max(maxX - minX, maxY - minY) * 1.0001f + 1e-3f;
+        float scale = 65535.0f / rootWidth_;
+
+        parallelFor(policy_, 0, blockCount(numPoints), [&](int block) {
+            for (int i = blockBegin(block); i < blockEnd(block, numPoints); ++i) {
+                std::uint32_t qx = static_cast<std::uint32_t>((stars.x[i] - minX) * scale);
+                std::uint32_t qy = static_cast<std::uint32_t>((stars.y[i] - minY) * scale);
+                std::uint32_t code = spreadBits(qx) | (spreadBits(qy) << 1);
+                keys_[i] = (static_cast<std::uint64_t>(code) << 32) | static_cast<std::uint32_t>(i);
+            }
+        });
+#ifdef GALAXY_HAS_STD_PARALLEL
+        std::sort(std::execution::par, keys_.begin(), keys_.end());
+#else
+        std::sort(keys_.begin(), keys_.end());
+#endif
+        parallelFor(policy_, 0, blockCount(numPoints), [&](int block) {
+            for (int k = blockBegin(block); k < blockEnd(block, numPoints); ++k) {
+                int i = static_cast<int>(keys_[k] & 0xffffffffu);
+                sortedX_[k] = stars.x[i];
+                sortedY_[k] = stars.y[i];
+            }
+        });
+
+        starGM_ = starsGM_ / numPoints;
+        nodeCount_.store(1);
+#pragma omp parallel
+#pragma omp single
+        buildNode(0, 0, numPoints, 0, rootWidth_);
+    }
+
+    void buildNode(int index, int begin, int end, int depth, float width) {
+        Node &node = nodes_[index];
+        node.begin = begin;
+        node.end = end;
+        node.width = width;
+
+        if (end - begin <= kLeafSize || depth == kMaxDepth) {
+            node.child = -1;
+            float sumX = 0.0f, sumY = 0.0f;
+            for (int k = begin; k < end; ++k) {
+                sumX += sortedX_[k];
+                sumY += sortedY_[k];
+            }
+            int count = end - begin;
+            node.mass = starGM_ * count;
+            node.comX = count ? sumX / count : 0.0f;
+            node.comY = count ? sumY / count : 0.0f;
+            return;
+        }
+
+        // Dentro de la celda los códigos comparten el prefijo, así que los 2 bits de este
+        // nivel crecen de forma monótona y cada cuadrante es un rango contiguo
+        int child = nodeCount_.fetch_add(4);
+        node.child = child;
+        int shift = 2 * (kMaxDepth - 1 - depth) + 32;
+        int bounds[5] = {begin, 0, 0, 0, end};
+        for (int q = 1; q < 4; ++q) {
+            bounds[q] = static_cast<int>(std::partition_point(
+                keys_.begin() + bounds[q - 1], keys_.begin() + end,
+                [shift, q](std::uint64_t key) { return static_cast<int>((key >> shift) & 3) < q; }) - keys_.begin());
+        }
+        for (int q = 0; q < 4; ++q) {
+            if (bounds[q + 1] - bounds[q] > kTaskSize) {
+#pragma omp task firstprivate(q, bounds, child, depth, width)
+                buildNode(child + q, bounds[q], bounds[q + 1], depth + 1, width * 0.5f);
+            } else {
+                buildNode(child + q, bounds[q], bounds[q + 1], depth + 1, width * 0.5f);
+            }
+        }
+#pragma omp taskwait
+
+        float mass = 0.0f, sumX = 0.0f, sumY = 0.0f;
+        for (int q = 0; q < 4; ++q) {
+            const Node &c = nodes_[child + q];
+            mass += c.mass;
+            sumX += c.mass * c.comX;
+            sumY += c.mass * c.comY;
+        }
+        node.mass = mass;
+        node.comX = mass > 0.0f ? sumX / mass : 0.0f;
+        node.comY = mass > 0.0f ? sumY / mass : 0.0f;
+    }
+
+    // Aceleración de cada estrella. Se recorren en el orden de Morton para que estrellas
+    // vecinas (que visitan casi los mismos nodos) las calcule el mismo hilo.
+    void computeForces(const StarStore &stars) {
+        int numPoints = static_cast<int>(stars.count());
+        buildTree(stars);
+
+        parallelFor(policy_, 0, blockCount(numPoints), [&](int block) {
+            for (int k = blockBegin(block); k < blockEnd(block, numPoints); ++k) {
+                int i = static_cast<int>(keys_[k] & 0xffffffffu);
+                accelerationAt(sortedX_[k], sortedY_[k], k, ax_[i], ay_[i]);
+            }
+        });
+        accelerationValid_ = true;
+    }
+
+    // Aceleración en (px, py) según el árbol actual más la masa central; skip es la posición
+    // (en el orden de Morton) de la estrella que no se atrae a sí misma, o -1
+    void accelerationAt(float px, float py, int skip, float &ax, float &ay) const {
+        const float theta2 = theta_ * theta_;
+        const float eps2 = kSoftening * kSoftening;
+        int stack[4 * kMaxDepth + 4];
+        float accX = 0.0f, accY = 0.0f;
+        int top = 0;
+        stack[top++] = 0;
+        while (top > 0) {
+            const Node &node = nodes_[stack[--top]];
+            if (node.mass == 0.0f) {
+                continue;
+            }
+            if (node.child < 0) {
+                for (int j = node.begin; j < node.end; ++j) {
+                    if (j == skip) continue;
+                    float dx = sortedX_[j] - px, dy = sortedY_[j] - py;
+                    float d2 = dx * dx + dy * dy + eps2;
+                    float inv = 1.0f / std::sqrt(d2);
+                    float f = starGM_ * inv * inv * inv;
+                    accX += f * dx;
+                    accY += f * dy;
+                }
+                continue;
+            }
+            float dx = node.comX - px, dy = node.comY - py;
+            float d2 = dx * dx + dy * dy + eps2;
+            if (node.width * node.width < theta2 * d2) {
+                float inv = 1.0f / std::sqrt(d2);
+                float f = node.mass * inv * inv * inv;
+                accX += f * dx;
+                accY += f * dy;
+            } else {
+                for (int q = 0; q < 4; ++q) {
+                    stack[top++] = node.child + q;
+                }
+            }
+        }
+
+        // Masa central
+        float dx = params_.centerX - px, dy = params_.centerY - py;
+        float d2 = dx * dx + dy * dy + eps2;
+        float inv = 1.0f / std::sqrt(d2);
+        float f = centralGM_ * inv * inv * inv;
+        ax = accX + f * dx;
+        ay = accY + f * dy;
+    }
+
+    // Recalcula el estado polar y hace reaparecer a las estrellas que cayeron al centro o escaparon.
+    // La primera media patada del paso siguiente usa ax_/ay_, así que la fuerza de una estrella
+    // que reaparece se calcula en su nueva posición con el árbol de este paso; en ese árbol
+    // todavía está en la posición anterior, un error del orden de la masa de una estrella.
+    void writeBackPolar(StarStore &stars) {
+        int numPoints = static_cast<int>(stars.count());
+        const float innerRadius = 0.02f * params_.maxRadius;
+        const float outerRadius = 2.0f * params_.maxRadius;
+        parallelFor(policy_, 0, blockCount(numPoints), [&](int block) {
+            for (int i = blockBegin(block); i < blockEnd(block, numPoints); ++i) {
+                float dx = stars.x[i] - params_.centerX;
+                float dy = stars.y[i] - params_.centerY;
+                float radius = std::sqrt(dx * dx + dy * dy);
+                float angle = std::atan2(dy, dx);
+                if (angle < 0.0f) angle += kTwoPi;
+                stars.radius[i] = radius;
+                stars.angle[i] = angle;
+                if (radius < innerRadius || radius > outerRadius) {
+                    respawnStar(stars, params_, i);
+                    setCircularVelocity(stars, i);
+                    accelerationAt(stars.x[i], stars.y[i], -1, ax_[i], ay_[i]);
+                }
+            }
+        });
+    }
+
+    GalaxyParams params_;
+    float theta_;
+    ParallelPolicy policy_;
+    float centralGM_;
+    float starsGM_;                   // GM de todas las estrellas juntas
+    float starGM_ = 0.0f;             // GM de una estrella
+    float rootWidth_ = 0.0f;
+    bool accelerationValid_ = false;
+
+    StarArray<float> vx_, vy_;        // Velocidad en píxeles por tick
+    StarArray<float> ax_, ay_;        // Aceleración del último cálculo de fuerzas
+    StarArray<std::uint64_t> keys_;   // Código de Morton (32 bits altos) e índice de la estrella
+    StarArray<float> sortedX_, sortedY_;
+    StarArray<Node> nodes_;
+    std::atomic<int> nodeCount_{0};
+};
+
+#endif //PARALLEL_SCREENSAVER_NBODY_H
@@ -0,0 +1,448 @@
+/*
+* Nombre: options.h
+* Autores:
+  - Andrés Montoya, 21552
+  - Fernanda Esquivel, 21542
+  - Francisco Castillo, 21562
+* Descripción: Opciones de línea de comandos compartidas por ambas versiones del Screen Saver.
+* Lenguaje: C++
+* Recursos: CLion, SFML
+* Historial:
+  - Creado el 17.10.2026
+  - Modificado el 17.10.2026 (cargar y guardar snapshots)
+  - Modificado el 17.10.2026 (control adaptativo de calidad)
+  - Modificado el 17.10.2026 (modo de bajo consumo con límite de FPS)
+  - Modificado el 17.10.2026 (estado compacto en punto fijo)
+  - Modificado el 17.10.2026 (rotación incremental sin seno ni coseno)
+  - Modificado el 17.10.2026 (orden espacial de las estrellas)
+  - Modificado el 17.10.2026 (listas de enteros, compartidas con las herramientas)
+  - Modificado el 17.10.2026 (frames en memoria compartida)
+  - Modificado el 17.10.2026 (opciones restringidas de la versión secuencial)
+  - Modificado el 17.10.2026 (límites de --points compartidos con --load)
+  - Modificado el 17.10.2026 (límite de --skip-to con N cuerpos)
+  - Modificado el 17.10.2026 (control de calidad apagado por defecto)
+  - Modificado el 17.10.2026 (--render-texture no se combina con --backend cpu)
+*/
+
+#ifndef PARALLEL_SCREENSAVER_OPTIONS_H
+#define PARALLEL_SCREENSAVER_OPTIONS_H
+
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "palette.h"
+#include "parallel_backend.h"
+#include "simd_update.h"
+
+// Estrellas permitidas con --points (y en un snapshot con --load); hasta kMaxLargePoints con --large
+const int kMinPoints = 5000;
+const int kMaxPoints = 30000;
+
+// Máximo de --skip-to con --physics nbody: 3600 pasos, unos 2 minutos en un núcleo con 15000 estrellas
+const double kMaxNBodySkipTo = 60;
+
+// Máximo de estrellas con --large (unos 1.3 GB de estado)
+const double kMaxLargePoints = 50000000;
+
+// Parámetros de la galaxia y del modo de ejecución
+struct Options {
+    int numPoints = 15000;             // Número de puntos en la galaxia
+    bool pointsGiven = false;          // --points explícito: el control de calidad no baja de ahí
+    bool largeN = false;               // Permitir millones de estrellas y dibujarlas por densidad
+    bool compact = false;              // Estado compacto de 6 bytes por estrella (implica --large)
+    bool compactCheck = false;         // Comparar el estado compacto con el de punto flotante
+    float maxRadius = 450.0f;          // Radio máximo de la galaxia
+    float speed = 0.035f;              // Velocidad de los puntos moviéndose hacia el centro
+    float baseRotationSpeed = 0.0007f; // Velocidad base de la rotación de la galaxia
+
+    bool headless = false;             // Ejecutar sin ventana y reportar tiempos
+    bool hasSeed = false;              // Si es falso se usa una semilla no determinista
+    unsigned seed = 0;                 // Semilla del generador de números aleatorios
+    int frames = 1000;                 // Número de frames a simular en modo headless
+    int threads = 0;                   // Número de hilos (0 = valor por defecto de OpenMP)
+    bool renderTexture = false;        // En modo headless dibujar también en un sf::RenderTexture
+    SimdLevel simd = SimdLevel::Auto;  // Conjunto de instrucciones del kernel de actualización
+    ParallelPolicy parallel;           // Reparto de la actualización entre hilos
+    PaletteKind palette = PaletteKind::Classic; // Paleta de colores inicial
+    bool colorFollowsRadius = false;   // Recalcular el color con el radio actual en cada frame
+    float extraStarRate = 10.0f;       // Estrellas adicionales que aparecen por segundo
+    bool pipeline = false;             // Simular el siguiente frame mientras se dibuja el actual
+    bool nbody = false;                // Física de N cuerpos en lugar de la espiral cinemática
+    bool incrementalRotation = false;  // Girar la posición anterior en lugar de calcular seno y coseno
+    int spatialOrder = 0;              // Frames entre reordenamientos por celdas de la pantalla (0 = nunca)
+    float theta = 0.5f;                // Ángulo de apertura de Barnes–Hut
+    float fpsLimit = -1.0f;            // Frames por segundo máximos (0 = sin límite, -1 = según --low-power)
+    bool lowPower = false;             // Límite de FPS y espera pasiva de los hilos entre frames
+    float simHz = 0.0f;                // Pasos de simulación por segundo en la ventana (0 = uno por frame)
+    float skipTo = 0.0f;               // Segundos que se adelanta la galaxia antes del primer frame
+    float targetFps = 0.0f;            // FPS que sostiene el control de calidad (0 = apagado)
+
+    bool cpuBackend = false;           // Dibujar en CPU por mosaicos en lugar de usar la ventana
+    int tileSize = 64;                 // Lado de los mosaicos del dibujo en CPU
+    std::string outputPattern;         // Secuencia PPM, p. ej. "frames/galaxia_%05d.ppm"
+    std::string rawOutput;             // Flujo RGB24 sin encabezado ("-" = salida estándar)
+    std::string shmName;               // Anillo de memoria compartida donde se publica cada frame
+    int shmSlots = 3;                  // Ranuras del anillo
+
+    std::string loadPath;              // Snapshot del que se carga la galaxia en lugar de generarla
+    std::string savePath;              // Snapshot donde se guarda el estado al terminar
+    float checkpointInterval = 0.0f;   // Segundos entre checkpoints en savePath (0 = solo al final)
+
+    std::string statsFile;             // Archivo con los percentiles por fase (.csv o .json)
+    float statsInterval = 5.0f;        // Segundos entre volcados de las estadísticas
+
+    bool interactive = true;           // Preguntar los parámetros por consola
+};
+
+inline void printUsage(const char *program) {
+    std::cout << "Uso: " << program << " [opciones]\n"
+              << "  --headless            Simular sin ventana e imprimir tiempos en CSV\n"
+              << "  --points N            Numero de puntos (5000 - 30000, o hasta 50000000 con --large)\n"
+              << "  --large               Galaxias de millones de estrellas, dibujadas por acumulacion de densidad\n"
+              << "  --compact             Con --headless o --backend cpu, guardar cada estrella en 6 bytes (implica --large)\n"
+              << "  --compact-check       Simular en paralelo el estado compacto y el de punto flotante y comparar el error\n"
+              << "  --max-radius R        Radio maximo (300.0 - 450.0)\n"
+              << "  --speed S             Velocidad (0.035 - 0.099)\n"
+              << "  --rotation B          Velocidad de rotacion base (0.0007 - 0.007)\n"
+              << "  --seed N              Semilla para una galaxia reproducible\n"
+              << "  --frames N            Frames a simular en modo headless (por defecto 1000)\n"
+              << "  --threads N           Numero de hilos de OpenMP\n"
+              << "  --render-texture      En modo headless dibujar en un sf::RenderTexture (requiere OpenGL)\n"
+              << "  --simd NIVEL          Kernel de actualizacion: auto, scalar, sse2, avx2 o avx512\n"
+              << "  --parallel NOMBRE     Reparto de la actualizacion: omp-static, omp-dynamic, omp-guided,\n"
+              << "                        pool (hilos con robo de trabajo) o stdpar (std::execution::par)\n"
+              << "  --chunk N             Bloques de 2048 estrellas por reparto (0 = por defecto)\n"
+              << "  --palette NOMBRE      Paleta de colores: clasica, fuego o hielo (tecla P para cambiarla)\n"
+              << "  --color-follows-radius  El color de cada estrella sigue a su radio actual\n"
+              << "  --extra-rate N        Estrellas adicionales por segundo (por defecto 10)\n"
+              << "  --pipeline            Calcular el frame N+1 en otro hilo mientras se dibuja el N\n"
+              << "  --physics NOMBRE      Movimiento: spiral (por defecto) o nbody (gravitacion con Barnes-Hut)\n"
+              << "  --theta T             Angulo de apertura de Barnes-Hut (por defecto 0.5; 0 = exacto)\n"
+              << "  --incremental-rotation  Girar la posicion del frame anterior sin calcular seno ni coseno\n"
+              << "  --spatial-order N     Reordenar las estrellas por celdas de la pantalla cada N frames (0 = nunca)\n"
+              << "  --target-fps N        Ajustar estrellas e hilos para sostener N FPS (0 = apagado, por defecto);\n"
+              << "                        con --points solo se ajustan los hilos\n"
+              << "  --fps N               Limitar a N frames por segundo durmiendo entre frames (0 = sin limite)\n"
+              << "  --low-power           Bajo consumo: 30 FPS salvo que se indique --fps y espera pasiva de los hilos\n"
+              << "  --sim-hz N            Pasos de simulacion por segundo en la ventana (por defecto uno por frame)\n"
+              << "  --skip-to S           Empezar con la galaxia adelantada S segundos (hasta 100000; el salto\n"
+              << "                        recorre cada reaparicion, unos 0.3 s por cada 5000 estrellas al maximo;\n"
+              << "                        con --physics nbody hasta 60, a 60 pasos por segundo)\n"
+              << "  --backend window|cpu  Dibujar en la ventana (por defecto) o en CPU sin ventana\n"
+              << "  --tile N              Lado de los mosaicos del dibujo en CPU (por defecto 64)\n"
+              << "  --output PATRON       Con --backend cpu, guardar cada frame como PPM (p. ej. f_%05d.ppm)\n"
+              << "  --raw ARCHIVO         Con --backend cpu, escribir frames RGB24 crudos ('-' = stdout)\n"
+              << "  --shm NOMBRE          Con --backend cpu, publicar cada frame en memoria compartida (Linux)\n"
+              << "  --shm-slots N         Ranuras del anillo de --shm (por defecto 3)\n"
+              << "  --load ARCHIVO        Cargar la galaxia de un snapshot (con sus parametros) en lugar de generarla\n"
+              << "  --save ARCHIVO        Guardar un snapshot del estado al terminar\n"
+              << "  --checkpoint S        Con --save, guardar tambien cada S segundos\n"
+              << "  --stats-file ARCHIVO  Guardar p50/p90/p99/max por fase en CSV (o JSON si termina en .json)\n"
+              << "  --stats-interval S    Segundos entre volcados de --stats-file (por defecto 5)\n"
+              << "  --help                Mostrar esta ayuda\n";
+}
+
+// Lee el valor que sigue a una opción; falla si no existe o no es numérico
+inline bool readValue(int argc, char **argv, int &i, double &value) {
+    if (i + 1 >= argc) {
+        std::cerr << "Falta el valor de " << argv[i] << "\n";
+        return false;
+    }
+    char *end = nullptr;
+    value = std::strtod(argv[++i], &end);
+    if (end == argv[i] || *end != '\0') {
+        std::cerr << "Valor invalido para " << argv[i - 1] << ": " << argv[i] << "\n";
+        return false;
+    }
+    return true;
+}
+
+inline bool checkRange(const char *name, double value, double min, double max) {
+    if (value < min || value > max) {
+        std::cerr << "Valor invalido para " << name << ". Debe estar entre " << min << " y " << max << ".\n";
+        return false;
+    }
+    return true;
+}
+
+// Lista de enteros separados por comas, cada uno dentro de [min, max]
+inline bool readList(int argc, char **argv, int &i, int min, int max, std::vector<int> &values) {
+    if (i + 1 >= argc) {
+        std::cerr << "Falta el valor de " << argv[i] << "\n";
+        return false;
+    }
+    const char *name = argv[i];
+    std::stringstream text(argv[++i]);
+    std::string item;
+    values.clear();
+    while (std::getline(text, item, ',')) {
+        char *end = nullptr;
+        long value = std::strtol(item.c_str(), &end, 10);
+        if (item.empty() || *end != '\0' || !checkRange(name, static_cast<double>(value), min, max)) {
+            if (item.empty() || *end != '\0') {
+                std::cerr << "Valor invalido para " << name << ": " << argv[i] << "\n";
+            }
+            return false;
+        }
+        values.push_back(static_cast<int>(value));
+    }
+    return !values.empty();
+}
+
+// Interpreta los argumentos de la línea de comandos. Devuelve falso si hay un error
+// o si se pidió la ayuda; en ese caso el programa debe terminar.
+inline bool parseOptions(int argc, char **argv, Options &options) {
+    for (int i = 1; i < argc; ++i) {
+        const char *arg = argv[i];
+        double value = 0.0;
+
+        if (std::strcmp(arg, "--help") == 0 || std::strcmp(arg, "-h") == 0) {
+            printUsage(argv[0]);
+            return false;
+        } else if (std::strcmp(arg, "--headless") == 0) {
+            options.headless = true;
+            options.interactive = false;
+        } else if (std::strcmp(arg, "--large") == 0) {
+            options.largeN = true;
+        } else if (std::strcmp(arg, "--compact") == 0 || std::strcmp(arg, "--compact-check") == 0) {
+            options.compact = true;
+            options.compactCheck = options.compactCheck || std::strcmp(arg, "--compact-check") == 0;
+            options.largeN = true;
+            options.interactive = false;
+        } else if (std::strcmp(arg, "--render-texture") == 0) {
+            options.renderTexture = true;
+        } else if (std::strcmp(arg, "--simd") == 0) {
+            if (i + 1 >= argc || !parseSimdLevel(argv[i + 1], options.simd)) {
+                std::cerr << "Valor invalido para --simd\n";
+                return false;
+            }
+            ++i;
+        } else if (std::strcmp(arg, "--parallel") == 0) {
+            if (i + 1 >= argc || !parseParallelBackend(argv[i + 1], options.parallel.backend)) {
+                std::cerr << "Valor invalido para --parallel\n";
+                return false;
+            }
+            ++i;
+        } else if (std::strcmp(arg, "--chunk") == 0) {
+            if (!readValue(argc, argv, i, value) || !checkRange(arg, value, 0, 1000000)) return false;
+            options.parallel.chunk = static_cast<int>(value);
+        } else if (std::strcmp(arg, "--palette") == 0) {
+            if (i + 1 >= argc || !parsePaletteKind(argv[i + 1], options.palette)) {
+                std::cerr << "Valor invalido para --palette\n";
+                return false;
+            }
+            ++i;
+        } else if (std::strcmp(arg, "--color-follows-radius") == 0) {
+            options.colorFollowsRadius = true;
+        } else if (std::strcmp(arg, "--extra-rate") == 0) {
+            if (!readValue(argc, argv, i, value) || !checkRange(arg, value, 0, 100000)) return false;
+            options.extraStarRate = static_cast<float>(value);
+        } else if (std::strcmp(arg, "--pipeline") == 0) {
+            options.pipeline = true;
+        } else if (std::strcmp(arg, "--physics") == 0) {
+            if (i + 1 >= argc || (std::strcmp(argv[i + 1], "spiral") != 0 && std::strcmp(argv[i + 1], "nbody") != 0)) {
+                std::cerr << "Valor invalido para --physics\n";
+                return false;
+            }
+            options.nbody = std::strcmp(argv[++i], "nbody") == 0;
+        } else if (std::strcmp(arg, "--incremental-rotation") == 0) {
+            options.incrementalRotation = true;
+        } else if (std::strcmp(arg, "--spatial-order") == 0) {
+            if (!readValue(argc, argv, i, value) || !checkRange(arg, value, 0, 100000)) return false;
+            options.spatialOrder = static_cast<int>(value);
+        } else if (std::strcmp(arg, "--theta") == 0) {
+            if (!readValue(argc, argv, i, value) || !checkRange(arg, value, 0.0, 2.0)) return false;
+            options.theta = static_cast<float>(value);
+        } else if (std::strcmp(arg, "--target-fps") == 0) {
+            if (!readValue(argc, argv, i, value) || !checkRange(arg, value, 0, 1000)) return false;
+            options.targetFps = static_cast<float>(value);
+        } else if (std::strcmp(arg, "--fps") == 0) {
+            if (!readValue(argc, argv, i, value) || !checkRange(arg, value, 0, 1000)) return false;
+            options.fpsLimit = static_cast<float>(value);
+        } else if (std::strcmp(arg, "--low-power") == 0) {
+            options.lowPower = true;
+        } else if (std::strcmp(arg, "--sim-hz") == 0) {
+            if (!readValue(argc, argv, i, value) || !checkRange(arg, value, 1, 1000)) return false;
+            options.simHz = static_cast<float>(value);
+        } else if (std::strcmp(arg, "--skip-to") == 0) {
+            if (!readValue(argc, argv, i, value) || !checkRange(arg, value, 0, 100000)) return false;
+            options.skipTo = static_cast<float>(value);
+        } else if (std::strcmp(arg, "--backend") == 0) {
+            if (i + 1 >= argc || (std::strcmp(argv[i + 1], "window") != 0 && std::strcmp(argv[i + 1], "cpu") != 0)) {
+                std::cerr << "Valor invalido para --backend\n";
+                return false;
+            }
+            options.cpuBackend = std::strcmp(argv[++i], "cpu") == 0;
+            if (options.cpuBackend) options.interactive = false;
+        } else if (std::strcmp(arg, "--tile") == 0) {
+            if (!readValue(argc, argv, i, value) || !checkRange(arg, value, 8, 800)) return false;
+            options.tileSize = static_cast<int>(value);
+        } else if (std::strcmp(arg, "--output") == 0 || std::strcmp(arg, "--raw") == 0) {
+            if (i + 1 >= argc) {
+                std::cerr << "Falta el valor de " << arg << "\n";
+                return false;
+            }
+            (std::strcmp(arg, "--output") == 0 ? options.outputPattern : options.rawOutput) = argv[++i];
+        } else if (std::strcmp(arg, "--shm") == 0) {
+            if (i + 1 >= argc) {
+                std::cerr << "Falta el valor de --shm\n";
+                return false;
+            }
+            options.shmName = argv[++i];
+        } else if (std::strcmp(arg, "--shm-slots") == 0) {
+            if (!readValue(argc, argv, i, value) || !checkRange(arg, value, 2, 64)) return false;
+            options.shmSlots = static_cast<int>(value);
+        } else if (std::strcmp(arg, "--load") == 0 || std::strcmp(arg, "--save") == 0) {
+            if (i + 1 >= argc) {
+                std::cerr << "Falta el valor de " << arg << "\n";
+                return false;
+            }
+            (std::strcmp(arg, "--load") == 0 ? options.loadPath : options.savePath) = argv[++i];
+            if (std::strcmp(arg, "--load") == 0) options.interactive = false;
+        } else if (std::strcmp(arg, "--checkpoint") == 0) {
+            if (!readValue(argc, argv, i, value) || !checkRange(arg, value, 0.1, 86400)) return false;
+            options.checkpointInterval = static_cast<float>(value);
+        } else if (std::strcmp(arg, "--stats-file") == 0) {
+            if (i + 1 >= argc) {
+                std::cerr << "Falta el valor de " << arg << "\n";
+                return false;
+            }
+            options.statsFile = argv[++i];
+        } else if (std::strcmp(arg, "--stats-interval") == 0) {
+            if (!readValue(argc, argv, i, value) || !checkRange(arg, value, 0.1, 86400)) return false;
+            options.statsInterval = static_cast<float>(value);
+        } else if (std::strcmp(arg, "--points") == 0) {
+            // El límite de 30000 se revisa al final, cuando ya se sabe si se pidió --large
+            if (!readValue(argc, argv, i, value) || !checkRange(arg, value, kMinPoints, kMaxLargePoints)) return false;
+            options.numPoints = static_cast<int>(value);
+            options.pointsGiven = true;
+            options.interactive = false;
+        } else if (std::strcmp(arg, "--max-radius") == 0) {
+            if (!readValue(argc, argv, i, value) || !checkRange(arg, value, 300.0, 450.0)) return false;
+            options.maxRadius = static_cast<float>(value);
+            options.interactive = false;
+        } else if (std::strcmp(arg, "--speed") == 0) {
+            if (!readValue(argc, argv, i, value) || !checkRange(arg, value, 0.035, 0.099)) return false;
+            options.speed = static_cast<float>(value);
+            options.interactive = false;
+        } else if (std::strcmp(arg, "--rotation") == 0) {
+            if (!readValue(argc, argv, i, value) || !checkRange(arg, value, 0.0007, 0.007)) return false;
+            options.baseRotationSpeed = static_cast<float>(value);
+            options.interactive = false;
+        } else if (std::strcmp(arg, "--seed") == 0) {
+            if (!readValue(argc, argv, i, value) || !checkRange(arg, value, 0, 4294967295.0)) return false;
+            options.seed = static_cast<unsigned>(value);
+            options.hasSeed = true;
+        } else if (std::strcmp(arg, "--frames") == 0) {
+            if (!readValue(argc, argv, i, value) || !checkRange(arg, value, 1, 1e9)) return false;
+            options.frames = static_cast<int>(value);
+        } else if (std::strcmp(arg, "--threads") == 0) {
+            if (!readValue(argc, argv, i, value) || !checkRange(arg, value, 1, 1024)) return false;
+            options.threads = static_cast<int>(value);
+        } else {
+            std::cerr << "Opcion desconocida: " << arg << "\n";
+            printUsage(argv[0]);
+            return false;
+        }
+    }
+    if (!options.largeN && options.numPoints > kMaxPoints) {
+        std::cerr << "Valor invalido para --points. Debe estar entre 5000 y 30000 (o usar --large).\n";
+        return false;
+    }
+    if (options.compact && (options.nbody || options.pipeline || !options.loadPath.empty() ||
+                            !options.savePath.empty())) {
+        std::cerr << "--compact no se puede combinar con --physics nbody, --pipeline, --load ni --save\n";
+        return false;
+    }
+    // Con N cuerpos el salto se integra en subpasos de un tick, cada uno con su árbol
+    if (options.nbody && options.skipTo > kMaxNBodySkipTo) {
+        std::cerr << "Con --physics nbody, --skip-to debe ser a lo mas " << kMaxNBodySkipTo
+                  << " (cada segundo son 60 pasos de Barnes-Hut)\n";
+        return false;
+    }
+    if (options.incrementalRotation && (options.nbody || options.compact)) {
+        std::cerr << "--incremental-rotation no se puede combinar con --physics nbody ni --compact\n";
+        return false;
+    }
+    if (options.spatialOrder > 0 && (options.nbody || options.compact)) {
+        std::cerr << "--spatial-order no se puede combinar con --physics nbody ni --compact\n";
+        return false;
+    }
+    if (options.compact && !options.compactCheck && !options.headless && !options.cpuBackend) {
+        std::cerr << "--compact requiere --headless o --backend cpu\n";
+        return false;
+    }
+    if (options.renderTexture && options.cpuBackend) {
+        std::cerr << "--render-texture no se puede combinar con --backend cpu\n";
+        return false;
+    }
+    // La ventana necesitaría leer cada frame de vuelta de la GPU: solo se publica desde el dibujo en CPU
+    if (!options.shmName.empty() && !options.cpuBackend) {
+        std::cerr << "--shm requiere --backend cpu\n";
+        return false;
+    }
+    if (options.fpsLimit < 0.0f) {
+        options.fpsLimit = options.lowPower ? 30.0f : 0.0f;
+    }
+    if (options.checkpointInterval > 0.0f && options.savePath.empty()) {
+        std::cerr << "--checkpoint requiere --save\n";
+        return false;
+    }
+    return true;
+}
+
+// Opciones que respeta la versión secuencial (main.cpp) y si llevan un valor
+struct SequentialOption {
+    const char *name;
+    bool takesValue;
+};
+
+const SequentialOption kSequentialOptions[] = {
+    {"--headless", false}, {"--points", true}, {"--max-radius", true}, {"--speed", true},
+    {"--rotation", true}, {"--seed", true}, {"--frames", true},
+};
+
+inline void printSequentialUsage(const char *program) {
+    std::cout << "Uso: " << program << " [opciones]\n"
+              << "  --headless            Simular sin ventana e imprimir tiempos en CSV\n"
+              << "  --points N            Numero de puntos (5000 - 30000)\n"
+              << "  --max-radius R        Radio maximo (300.0 - 450.0)\n"
+              << "  --speed S             Velocidad (0.035 - 0.099)\n"
+              << "  --rotation B          Velocidad de rotacion base (0.0007 - 0.007)\n"
+              << "  --seed N              Semilla para una galaxia reproducible\n"
+              << "  --frames N            Frames a simular en modo headless (por defecto 1000)\n"
+              << "  --help                Mostrar esta ayuda\n";
+}
+
+// Como parseOptions, pero rechaza las opciones que solo tiene la versión paralelizada en
+// lugar de ignorarlas. Sin --large, --points queda entre 5000 y 30000.
+inline bool parseSequentialOptions(int argc, char **argv, Options &options) {
+    for (int i = 1; i < argc; ++i) {
+        const char *arg = argv[i];
+        if (std::strcmp(arg, "--help") == 0 || std::strcmp(arg, "-h") == 0) {
+            printSequentialUsage(argv[0]);
+            return false;
+        }
+        const SequentialOption *match = nullptr;
+        for (const SequentialOption &option : kSequentialOptions) {
+            if (std::strcmp(arg, option.name) == 0) {
+                match = &option;
+            }
+        }
+        if (!match) {
+            std::cerr << "Opcion no disponible en la version secuencial: " << arg << "\n";
+            printSequentialUsage(argv[0]);
+            return false;
+        }
+        if (match->takesValue) {
+            ++i;
+        }
+    }
+    return parseOptions(argc, argv, options);
+}
+
+#endif //PARALLEL_SCREENSAVER_OPTIONS_H
@@ -0,0 +1,160 @@
+/*
+* Nombre: palette.h
+* Autores:
+  - Andrés Montoya, 21552
+  - Fernanda Esquivel, 21542
+  - Francisco Castillo, 21562
+* Descripción: Paletas de color precalculadas (tabla de 1024 entradas sobre el radio normalizado).
+* Lenguaje: C++
+* Recursos: CLion
+* Historial:
+  - Creado el 17.10.2026
+  - Modificado el 17.10.2026 (índice de color de una estrella, para componer partes en otro proceso)
+*/
+
+#ifndef PARALLEL_SCREENSAVER_PALETTE_H
+#define PARALLEL_SCREENSAVER_PALETTE_H
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "star_store.h"
+
+struct PaletteColor {
+    std::uint8_t r, g, b, a;
+};
+
+enum class PaletteKind {
+    Classic, // Amarillo en el centro, azul en la zona media y violeta en los bordes
+    Fire,    // Blanco amarillento en el centro hacia rojo oscuro en los bordes
+    Ice,     // Blanco en el centro hacia cian y azul profundo en los bordes
+    Count
+};
+
+inline const char *paletteName(PaletteKind kind) {
+    switch (kind) {
+        case PaletteKind::Fire: return "fuego";
+        case PaletteKind::Ice: return "hielo";
+        default: return "clasica";
+    }
+}
+
+inline bool parsePaletteKind(const char *name, PaletteKind &kind) {
+    for (int i = 0; i < static_cast<int>(PaletteKind::Count); ++i) {
+        if (std::strcmp(name, paletteName(static_cast<PaletteKind>(i))) == 0) {
+            kind = static_cast<PaletteKind>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+inline std::uint8_t toChannel(float value) {
+    if (value < 0.0f) return 0;
+    if (value > 255.0f) return 255;
+    return static_cast<std::uint8_t>(value);
+}
+
+// Degradado original del Screen Saver para un parámetro t (radio normalizado)
+inline PaletteColor classicGradient(float t) {
+    if (t < 0.3f) {
+        // Amarillo oscuro hacia el centro
+        return {200, 200, toChannel(100 + 55 * t / 0.3f), 255};
+    } else if (t < 0.7f) {
+        // Azul oscuro en la zona media
+        return {toChannel(100 * (1 - (t - 0.3f) / 0.4f)), toChannel(100 + 55 * (t - 0.3f) / 0.4f), 200, 255};
+    }
+    // Violeta oscuro en los bordes
+    return {toChannel(80 + 127 * (t - 0.7f) / 0.3f), 0, 180, 255};
+}
+
+inline PaletteColor fireGradient(float t) {
+    float u = t / kPaletteRange;
+    return {toChannel(255 - 90 * u), toChannel(240 * (1 - u) * (1 - u)), toChannel(180 * (1 - 3 * u)), 255};
+}
+
+inline PaletteColor iceGradient(float t) {
+    float u = t / kPaletteRange;
+    return {toChannel(220 * (1 - 1.5f * u)), toChannel(240 - 170 * u), toChannel(255 - 60 * u), 255};
+}
+
+// Tabla de colores indexada por el índice de paleta de cada estrella (ver paletteIndex).
+// Se calcula una sola vez, así que obtener el color cuesta una lectura de la tabla.
+class Palette {
+public:
+    explicit Palette(PaletteKind kind = PaletteKind::Classic) {
+        setKind(kind);
+    }
+
+    void setKind(PaletteKind kind) {
+        kind_ = kind;
+        table_.resize(kPaletteLevels);
+        for (int i = 0; i < kPaletteLevels; ++i) {
+            float t = paletteParameter(static_cast<std::uint16_t>(i));
+            switch (kind) {
+                case PaletteKind::Fire: table_[i] = fireGradient(t); break;
+                case PaletteKind::Ice: table_[i] = iceGradient(t); break;
+                default: table_[i] = classicGradient(t); break;
+            }
+        }
+    }
+
+    // Pasa a la siguiente paleta disponible
+    void cycle() {
+        setKind(static_cast<PaletteKind>((static_cast<int>(kind_) + 1) % static_cast<int>(PaletteKind::Count)));
+    }
+
+    PaletteKind kind() const {
+        return kind_;
+    }
+
+    const PaletteColor &operator[](std::uint16_t index) const {
+        return table_[index];
+    }
+
+    // Con colorFollowsRadius el color sigue al radio actual de la estrella en cada frame;
+    // si no, se conserva el color asignado al generarla o al reaparecer.
+    void setColorFollowsRadius(bool follow, float maxRadius) {
+        followRadius_ = follow;
+        invMaxRadius_ = 1.0f / maxRadius;
+    }
+
+    bool colorFollowsRadius() const {
+        return followRadius_;
+    }
+
+    std::uint16_t indexOf(const StarStore &stars, std::size_t i) const {
+        if (followRadius_) {
+            return paletteIndex(stars.radius[i] * invMaxRadius_);
+        }
+        return stars.palette[i];
+    }
+
+    const PaletteColor &colorOf(const StarStore &stars, std::size_t i) const {
+        return table_[indexOf(stars, i)];
+    }
+
+private:
+    PaletteKind kind_ = PaletteKind::Classic;
+    std::vector<PaletteColor> table_;
+    bool followRadius_ = false;
+    float invMaxRadius_ = 1.0f;
+};
+
+// Índice de paleta de una estrella recién generada
+inline std::uint16_t spawnPaletteIndex(float normalizedRadius) {
+    return paletteIndex(normalizedRadius);
+}
+
+// Índice de paleta de una estrella que reaparece en el borde. Por encima de 0.7 el ciclo
+// vuelve al amarillo en lugar de quedarse en violeta.
+inline std::uint16_t respawnPaletteIndex(float normalizedRadius) {
+    if (normalizedRadius < 0.7f) {
+        return paletteIndex(normalizedRadius);
+    }
+    return paletteIndex(std::fmod(normalizedRadius - 0.7f, 1.0f));
+}
+
+#endif //PARALLEL_SCREENSAVER_PALETTE_H
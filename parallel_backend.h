@@ -0,0 +1,361 @@
+/*
+* Nombre: parallel_backend.h
+* Autores:
+  - Andrés Montoya, 21552
+  - Fernanda Esquivel, 21542
+  - Francisco Castillo, 21562
+* Descripción: Políticas intercambiables para los ciclos paralelos: OpenMP (static, dynamic, guided),
+  un pool de hilos con robo de trabajo y los algoritmos paralelos de C++17.
+* Lenguaje: C++
+* Recursos: CLion
+* Historial:
+  - Creado el 17.10.2026
+  - Modificado el 17.10.2026 (el pool compartido se puede recrear con otra cantidad de hilos)
+  - Modificado el 17.10.2026 (espera pasiva de quien llama al pool, para --low-power)
+  - Modificado el 17.10.2026 (stdpar recorre un iterador de conteo en lugar de un arreglo de índices)
+*/
+
+#ifndef PARALLEL_SCREENSAVER_PARALLEL_BACKEND_H
+#define PARALLEL_SCREENSAVER_PARALLEL_BACKEND_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <omp.h>
+
+#if defined(__has_include)
+#if __has_include(<execution>) && __cplusplus >= 201703L
+#include <execution>
+#define GALAXY_HAS_STD_PARALLEL 1
+#endif
+#endif
+
+// Forma de repartir las iteraciones de un ciclo paralelo
+enum class ParallelBackend {
+    OmpStatic,   // Bloques iguales y fijos por hilo (el comportamiento original)
+    OmpDynamic,  // Cada hilo toma el siguiente bloque libre
+    OmpGuided,   // Bloques que se achican a medida que queda menos trabajo
+    Pool,        // Pool persistente de std::thread con robo de trabajo
+    StdPar       // std::for_each con std::execution::par
+};
+
+struct ParallelPolicy {
+    ParallelBackend backend = ParallelBackend::OmpStatic;
+    int chunk = 0;  // Iteraciones por bloque (0 = valor por defecto de cada política)
+};
+
+inline const char *parallelBackendName(ParallelBackend backend) {
+    switch (backend) {
+        case ParallelBackend::OmpStatic: return "omp-static";
+        case ParallelBackend::OmpDynamic: return "omp-dynamic";
+        case ParallelBackend::OmpGuided: return "omp-guided";
+        case ParallelBackend::Pool: return "pool";
+        case ParallelBackend::StdPar: return "stdpar";
+    }
+    return "?";
+}
+
+inline bool parseParallelBackend(const char *text, ParallelBackend &backend) {
+    const ParallelBackend all[] = {ParallelBackend::OmpStatic, ParallelBackend::OmpDynamic,
+                                   ParallelBackend::OmpGuided, ParallelBackend::Pool, ParallelBackend::StdPar};
+    for (ParallelBackend candidate : all) {
+        if (std::strcmp(text, parallelBackendName(candidate)) == 0) {
+            backend = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Pool de hilos persistente. Cada hilo tiene su propia cola: saca trabajo del final de la
+// suya y, si está vacía, roba del principio de la de otro. Quien llama a parallelFor también
+// ejecuta bloques mientras espera, así que un parallelFor dentro de otro (desde un hilo del
+// pool) no se bloquea: el hilo sigue avanzando trabajo pendiente hasta que termina el suyo.
+class WorkStealingPool {
+public:
+    // threads cuenta también al hilo que llama, así que se crean threads - 1 trabajadores
+    explicit WorkStealingPool(int threads)
+        : queues_(threads > 1 ? threads : 1) {
+        for (int i = 1; i < static_cast<int>(queues_.size()); ++i) {
+            workers_.emplace_back(&WorkStealingPool::workerLoop, this, i);
+        }
+    }
+
+    ~WorkStealingPool() {
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex_);
+            stop_ = true;
+        }
+        wake_.notify_all();
+        for (std::thread &worker : workers_) {
+            worker.join();
+        }
+    }
+
+    int threadCount() const {
+        return static_cast<int>(queues_.size());
+    }
+
+    // Ejecuta body(begin, end) sobre bloques de grain iteraciones y regresa cuando terminaron todos
+    void parallelFor(int begin, int end, int grain, const std::function<void(int, int)> &body) {
+        if (end <= begin) {
+            return;
+        }
+        if (grain <= 0) {
+            // Unos cuatro bloques por hilo para que el robo pueda equilibrar la carga
+            grain = std::max(1, (end - begin) / (4 * threadCount()));
+        }
+
+        Job job;
+        job.body = &body;
+        int chunks = (end - begin + grain - 1) / grain;
+        job.pending.store(chunks, std::memory_order_relaxed);
+
+        int self = currentSlot();
+        {
+            Queue &queue = queues_[self];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            for (int start = begin; start < end; start += grain) {
+                queue.tasks.push_back(Task{&job, start, std::min(end, start + grain)});
+            }
+        }
+        queued_.fetch_add(chunks, std::memory_order_release);
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex_);
+        }
+        wake_.notify_all();
+
+        // Ayudar (con este trabajo o con cualquier otro) hasta que terminen todos los bloques.
+        // Sin nada que tomar, los bloques que faltan ya los corre otro hilo: se cede el núcleo o,
+        // con espera pasiva, se duerme hasta que terminen o haya más bloques en las colas.
+        while (job.pending.load(std::memory_order_acquire) > 0) {
+            Task task;
+            if (takeTask(self, task)) {
+                run(task);
+            } else if (passiveWait().load(std::memory_order_relaxed)) {
+                std::unique_lock<std::mutex> lock(sleepMutex_);
+                wake_.wait(lock, [this, &job] {
+                    return job.pending.load(std::memory_order_acquire) == 0 ||
+                           queued_.load(std::memory_order_acquire) > 0;
+                });
+            } else {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    // Con espera pasiva (--low-power) quien llama a parallelFor duerme en lugar de ceder el
+    // núcleo en un ciclo mientras los trabajadores terminan; los trabajadores ya duermen sin trabajo
+    static void setPassiveWait(bool passive) {
+        passiveWait().store(passive, std::memory_order_relaxed);
+    }
+
+    // Pool compartido del programa, con tantos hilos como OpenMP la primera vez que se usa
+    static WorkStealingPool &shared() {
+        return *sharedSlot();
+    }
+
+    // Recrea el pool compartido con otra cantidad de hilos (omp_set_num_threads no lo cambia).
+    // No puede haber ningún parallelFor en curso.
+    static void resizeShared(int threads) {
+        std::unique_ptr<WorkStealingPool> &pool = sharedSlot();
+        if (pool->threadCount() != std::max(threads, 1)) {
+            pool.reset();
+            pool.reset(new WorkStealingPool(threads));
+        }
+    }
+
+private:
+    static std::atomic<bool> &passiveWait() {
+        static std::atomic<bool> passive{false};
+        return passive;
+    }
+
+    static std::unique_ptr<WorkStealingPool> &sharedSlot() {
+        static std::unique_ptr<WorkStealingPool> pool(new WorkStealingPool(omp_get_max_threads()));
+        return pool;
+    }
+
+    struct Job {
+        const std::function<void(int, int)> *body = nullptr;
+        std::atomic<int> pending{0};
+    };
+
+    struct Task {
+        Job *job;
+        int begin;
+        int end;
+    };
+
+    // Cada cola en su propia línea de caché para que los hilos no compitan por ella
+    struct alignas(64) Queue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    // Los hilos externos usan la cola 0; cada trabajador, la suya
+    int currentSlot() const {
+        return workerSlot() >= 0 && workerPool() == this ? workerSlot() : 0;
+    }
+
+    static int &workerSlot() {
+        static thread_local int slot = -1;
+        return slot;
+    }
+
+    static const WorkStealingPool *&workerPool() {
+        static thread_local const WorkStealingPool *pool = nullptr;
+        return pool;
+    }
+
+    bool takeTask(int self, Task &task) {
+        int count = static_cast<int>(queues_.size());
+        for (int k = 0; k < count; ++k) {
+            Queue &queue = queues_[(self + k) % count];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            if (queue.tasks.empty()) {
+                continue;
+            }
+            // La cola propia se usa como pila (lo último que se partió sigue en caché); a las
+            // demás se les roba lo más viejo, que suele ser el bloque más grande pendiente
+            if (k == 0) {
+                task = queue.tasks.back();
+                queue.tasks.pop_back();
+            } else {
+                task = queue.tasks.front();
+                queue.tasks.pop_front();
+            }
+            queued_.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+        return false;
+    }
+
+    void run(const Task &task) {
+        (*task.job->body)(task.begin, task.end);
+        // Después de este decremento el trabajo puede ya no existir: solo se usa el resultado
+        bool last = task.job->pending.fetch_sub(1, std::memory_order_acq_rel) == 1;
+        if (last && passiveWait().load(std::memory_order_relaxed)) {
+            {
+                std::lock_guard<std::mutex> lock(sleepMutex_);
+            }
+            wake_.notify_all();
+        }
+    }
+
+    void workerLoop(int slot) {
+        workerSlot() = slot;
+        workerPool() = this;
+        for (;;) {
+            Task task;
+            if (takeTask(slot, task)) {
+                run(task);
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(sleepMutex_);
+            wake_.wait(lock, [this] { return stop_ || queued_.load(std::memory_order_acquire) > 0; });
+            if (stop_) {
+                return;
+            }
+        }
+    }
+
+    std::vector<Queue> queues_;
+    std::vector<std::thread> workers_;
+    std::atomic<int> queued_{0};     // Bloques en las colas, para saber cuándo dormir
+    std::mutex sleepMutex_;
+    std::condition_variable wake_;
+    bool stop_ = false;
+};
+
+// Iterador de acceso aleatorio sobre los enteros: los algoritmos paralelos recorren iteradores
+// y así no hace falta llenar un arreglo con los índices en cada llamada
+class IndexIterator {
+public:
+    typedef std::random_access_iterator_tag iterator_category;
+    typedef int value_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef const int *pointer;
+    typedef int reference;
+
+    IndexIterator() = default;
+    explicit IndexIterator(int value) : value_(value) {}
+
+    int operator*() const { return value_; }
+    int operator[](difference_type n) const { return value_ + static_cast<int>(n); }
+
+    IndexIterator &operator++() { ++value_; return *this; }
+    IndexIterator operator++(int) { IndexIterator old = *this; ++value_; return old; }
+    IndexIterator &operator--() { --value_; return *this; }
+    IndexIterator operator--(int) { IndexIterator old = *this; --value_; return old; }
+    IndexIterator &operator+=(difference_type n) { value_ += static_cast<int>(n); return *this; }
+    IndexIterator &operator-=(difference_type n) { value_ -= static_cast<int>(n); return *this; }
+
+    friend IndexIterator operator+(IndexIterator it, difference_type n) { return it += n; }
+    friend IndexIterator operator+(difference_type n, IndexIterator it) { return it += n; }
+    friend IndexIterator operator-(IndexIterator it, difference_type n) { return it -= n; }
+    friend difference_type operator-(IndexIterator a, IndexIterator b) {
+        return static_cast<difference_type>(a.value_) - b.value_;
+    }
+
+    friend bool operator==(IndexIterator a, IndexIterator b) { return a.value_ == b.value_; }
+    friend bool operator!=(IndexIterator a, IndexIterator b) { return a.value_ != b.value_; }
+    friend bool operator<(IndexIterator a, IndexIterator b) { return a.value_ < b.value_; }
+    friend bool operator>(IndexIterator a, IndexIterator b) { return a.value_ > b.value_; }
+    friend bool operator<=(IndexIterator a, IndexIterator b) { return a.value_ <= b.value_; }
+    friend bool operator>=(IndexIterator a, IndexIterator b) { return a.value_ >= b.value_; }
+
+private:
+    int value_ = 0;
+};
+
+// Ejecuta body(i) para i en [begin, end) con la política indicada
+template <typename F>
+void parallelFor(const ParallelPolicy &policy, int begin, int end, F body) {
+    switch (policy.backend) {
+        case ParallelBackend::OmpStatic:
+        case ParallelBackend::OmpDynamic:
+        case ParallelBackend::OmpGuided: {
+            omp_sched_t kind = policy.backend == ParallelBackend::OmpStatic ? omp_sched_static
+                             : policy.backend == ParallelBackend::OmpDynamic ? omp_sched_dynamic
+                             : omp_sched_guided;
+            omp_set_schedule(kind, policy.chunk);
+#pragma omp parallel for schedule(runtime)
+            for (int i = begin; i < end; ++i) {
+                body(i);
+            }
+            break;
+        }
+        case ParallelBackend::Pool: {
+            std::function<void(int, int)> range = [&body](int first, int last) {
+                for (int i = first; i < last; ++i) {
+                    body(i);
+                }
+            };
+            WorkStealingPool::shared().parallelFor(begin, end, policy.chunk, range);
+            break;
+        }
+        case ParallelBackend::StdPar: {
+            if (end <= begin) {
+                break;
+            }
+#ifdef GALAXY_HAS_STD_PARALLEL
+            std::for_each(std::execution::par, IndexIterator(begin), IndexIterator(end), body);
+#else
+            std::for_each(IndexIterator(begin), IndexIterator(end), body); // Sin <execution>: en serie
+#endif
+            break;
+        }
+    }
+}
+
+#endif //PARALLEL_SCREENSAVER_PARALLEL_BACKEND_H
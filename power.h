@@ -0,0 +1,119 @@
+/*
+* Nombre: power.h
+* Autores:
+  - Andrés Montoya, 21552
+  - Fernanda Esquivel, 21542
+  - Francisco Castillo, 21562
+* Descripción: Modo de bajo consumo: límite de FPS con espera dormida, espera pasiva de los
+  hilos de OpenMP y medición del tiempo de CPU del proceso.
+* Lenguaje: C++
+* Recursos: CLion
+* Historial:
+  - Creado el 17.10.2026
+  - Modificado el 17.10.2026 (espera pasiva sin volver a ejecutar el programa; también en el pool)
+*/
+
+#ifndef PARALLEL_SCREENSAVER_POWER_H
+#define PARALLEL_SCREENSAVER_POWER_H
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+
+#include "parallel_backend.h"
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <sys/resource.h>
+#endif
+
+// Segundos de CPU (usuario + sistema) que lleva el proceso, sumando todos sus hilos
+inline double processCpuSeconds() {
+#ifdef _WIN32
+    FILETIME creation, exit, kernel, user;
+    if (!GetProcessTimes(GetCurrentProcess(), &creation, &exit, &kernel, &user)) {
+        return 0.0;
+    }
+    auto toSeconds = [](const FILETIME &t) {
+        return (static_cast<unsigned long long>(t.dwHighDateTime) << 32 | t.dwLowDateTime) * 1e-7;
+    };
+    return toSeconds(kernel) + toSeconds(user);
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) {
+        return 0.0;
+    }
+    return usage.ru_utime.tv_sec + usage.ru_stime.tv_sec +
+           (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) * 1e-6;
+#endif
+}
+
+// Los hilos de OpenMP por defecto siguen girando un rato al terminar cada región paralela para
+// arrancar antes la siguiente; entre frames eso es CPU gastada sin hacer nada. Debe llamarse
+// antes de la primera región paralela. El runtime de LLVM/Intel lee KMP_BLOCKTIME y
+// OMP_WAIT_POLICY al iniciarse con esa primera región, así que basta ponerlas aquí; libgomp
+// (GCC) las lee al cargarse, antes de main, y ahí solo sirven si las pone quien lanza el
+// programa. Los valores que ya definió el usuario se respetan. El pool con robo de trabajo
+// no depende del runtime: se le pide espera pasiva directamente.
+inline void requestPassiveWait() {
+    WorkStealingPool::setPassiveWait(true);
+    if (std::getenv("OMP_WAIT_POLICY")) {
+        return;
+    }
+#ifdef _WIN32
+    _putenv_s("OMP_WAIT_POLICY", "passive");
+    _putenv_s("KMP_BLOCKTIME", "0");
+#else
+    setenv("OMP_WAIT_POLICY", "passive", 0);
+    setenv("KMP_BLOCKTIME", "0", 0);
+#endif
+#if defined(__GNUC__) && !defined(__clang__)
+    std::cerr << "Aviso: con libgomp defina OMP_WAIT_POLICY=passive al lanzar el programa para que los "
+                 "hilos de OpenMP no esperen girando\n";
+#endif
+}
+
+// Limita los FPS durmiendo hasta el inicio del siguiente frame. Los plazos se calculan a partir
+// del anterior (no de cuándo terminó el frame), así que los errores del sleep no se acumulan; si
+// un frame se atrasa más de un periodo completo se reinicia el plazo en lugar de correr para
+// alcanzarlo.
+class FramePacer {
+public:
+    explicit FramePacer(double fps = 0.0)
+        : period_(fps > 0.0 ? std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / fps))
+                            : Clock::duration::zero()),
+          next_(Clock::now() + period_) {}
+
+    bool enabled() const {
+        return period_ > Clock::duration::zero();
+    }
+
+    // Duerme hasta el siguiente plazo y devuelve los segundos dormidos
+    double wait() {
+        if (!enabled()) {
+            return 0.0;
+        }
+        Clock::time_point now = Clock::now();
+        if (now < next_) {
+            std::this_thread::sleep_until(next_);
+        }
+        Clock::time_point woke = Clock::now();
+        next_ += period_;
+        if (next_ < woke - period_) {
+            next_ = woke + period_;
+        }
+        return std::chrono::duration<double>(woke - now).count();
+    }
+
+private:
+    typedef std::chrono::steady_clock Clock;
+    Clock::duration period_;
+    Clock::time_point next_;
+};
+
+#endif //PARALLEL_SCREENSAVER_POWER_H
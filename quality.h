@@ -0,0 +1,170 @@
+/*
+* Nombre: quality.h
+* Autores:
+  - Andrés Montoya, 21552
+  - Fernanda Esquivel, 21542
+  - Francisco Castillo, 21562
+* Descripción: Control de calidad en lazo cerrado: ajusta las estrellas activas, las estrellas
+  adicionales y los hilos para mantener un tiempo por frame objetivo.
+* Lenguaje: C++
+* Recursos: CLion
+* Historial:
+  - Creado el 17.10.2026
+  - Modificado el 17.10.2026 (los hilos pueden quedar fijos)
+*/
+
+#ifndef PARALLEL_SCREENSAVER_QUALITY_H
+#define PARALLEL_SCREENSAVER_QUALITY_H
+
+#include <algorithm>
+#include <atomic>
+#include <vector>
+
+// Nivel elegido por el controlador. Lo lee el paso de la simulación, que puede correr en
+// el hilo de --pipeline, así que los valores son atómicos.
+struct QualitySettings {
+    std::atomic<int> stars{0};    // Estrellas activas (0 = no cambiar)
+    std::atomic<int> threads{0};  // Hilos de OpenMP (0 = no cambiar)
+};
+
+// Mide el costo de cada frame en ventanas de kWindow frames y usa la mediana de cada ventana
+// (un frame lento aislado no cuenta). El costo se separa en la parte que depende de las
+// estrellas (actualización y dibujo) y el resto, y con eso se estima cuántas estrellas
+// caben en el objetivo.
+//
+// Para no oscilar hay una banda muerta entre kLowerBand y kUpperBand del objetivo: por encima
+// se baja la calidad en la siguiente ventana; por debajo solo se sube después de kPatience
+// ventanas seguidas, y en pasos de a lo más un 25 %. Tras cada cambio se ignora una ventana
+// mientras el cambio llega a los frames (con --pipeline llega un frame tarde).
+class QualityController {
+public:
+    // Con adjustThreads en falso los hilos se quedan en maxThreads
+    QualityController(double targetSeconds, int maxStars, int minStars, float maxSpawnRate, int maxThreads,
+                      bool adjustThreads = true)
+        : target_(targetSeconds), maxStars_(maxStars), minStars_(std::min(minStars, maxStars)),
+          maxSpawnRate_(maxSpawnRate), maxThreads_(std::max(1, maxThreads)),
+          stars_(maxStars), threads_(std::max(1, maxThreads)), threadFloor_(adjustThreads ? 1 : threads_) {
+        work_.reserve(kWindow);
+        starCost_.reserve(kWindow);
+    }
+
+    // Registra un frame: workSeconds es su costo sin la espera del display y starSeconds la
+    // parte que escala con las estrellas. Devuelve true si cambió el nivel.
+    bool record(double workSeconds, double starSeconds) {
+        work_.push_back(workSeconds);
+        starCost_.push_back(starSeconds);
+        if (static_cast<int>(work_.size()) < kWindow) {
+            return false;
+        }
+        double work = median(work_);
+        double starCost = median(starCost_);
+        work_.clear();
+        starCost_.clear();
+        return decide(work, starCost);
+    }
+
+    int stars() const {
+        return stars_;
+    }
+
+    int threads() const {
+        return threads_;
+    }
+
+    // Las estrellas adicionales siguen la misma proporción que las de la galaxia
+    float spawnRate() const {
+        return maxStars_ > 0 ? maxSpawnRate_ * static_cast<float>(stars_) / maxStars_ : maxSpawnRate_;
+    }
+
+    void publish(QualitySettings &settings) const {
+        settings.stars.store(stars_, std::memory_order_relaxed);
+        settings.threads.store(threads_, std::memory_order_relaxed);
+    }
+
+private:
+    static const int kWindow = 30;
+    static const int kPatience = 3;
+    static constexpr double kUpperBand = 1.1;   // Más lento que esto: bajar la calidad
+    static constexpr double kLowerBand = 0.75;  // Más rápido que esto: se puede subir
+    static constexpr double kIdleBand = 0.5;    // Con todo al máximo y tanto margen, sobran hilos
+    static constexpr double kAim = 0.85;        // Fracción del objetivo que se busca al ajustar
+
+    static double median(std::vector<double> values) {
+        std::nth_element(values.begin(), values.begin() + values.size() / 2, values.end());
+        return values[values.size() / 2];
+    }
+
+    // Estrellas con las que el costo estimado sería kAim del objetivo
+    int starsFor(double work, double starCost) const {
+        double perStar = starCost / std::max(stars_, 1);
+        if (perStar <= 0.0) {
+            return maxStars_;
+        }
+        double fixed = std::max(0.0, work - starCost);
+        double stars = (kAim * target_ - fixed) / perStar;
+        return static_cast<int>(std::max(0.0, std::min(stars, static_cast<double>(maxStars_))));
+    }
+
+    bool decide(double work, double starCost) {
+        if (settle_ > 0) {
+            --settle_;
+            return false;
+        }
+
+        if (work > kUpperBand * target_) {
+            calm_ = 0;
+            // Primero recuperar los hilos que se habían quitado; este nivel ya no sobra
+            if (threads_ < maxThreads_) {
+                ++threads_;
+                threadFloor_ = threads_;
+                return changed();
+            }
+            int next = std::max(std::max(starsFor(work, starCost), stars_ / 2), minStars_);
+            if (next < stars_) {
+                stars_ = next;
+                return changed();
+            }
+            return false;
+        }
+
+        if (work >= kLowerBand * target_ || ++calm_ < kPatience) {
+            if (work >= kLowerBand * target_) {
+                calm_ = 0;
+            }
+            return false;
+        }
+        calm_ = 0;
+        if (stars_ < maxStars_) {
+            int next = std::min(std::min(starsFor(work, starCost), stars_ + stars_ / 4 + 1), maxStars_);
+            if (next > stars_) {
+                stars_ = next;
+                return changed();
+            }
+        } else if (work < kIdleBand * target_ && threads_ > threadFloor_) {
+            --threads_;
+            return changed();
+        }
+        return false;
+    }
+
+    bool changed() {
+        settle_ = 1;
+        return true;
+    }
+
+    double target_;
+    int maxStars_;
+    int minStars_;
+    float maxSpawnRate_;
+    int maxThreads_;
+
+    int stars_;
+    int threads_;
+    int threadFloor_;      // Menos hilos que esto ya resultó demasiado lento (o no se pueden cambiar)
+    int calm_ = 0;         // Ventanas seguidas con margen
+    int settle_ = 0;       // Ventanas que faltan por ignorar tras un cambio
+    std::vector<double> work_;
+    std::vector<double> starCost_;
+};
+
+#endif //PARALLEL_SCREENSAVER_QUALITY_H
@@ -0,0 +1,146 @@
+/*
+* Nombre: sequential.h
+* Autores:
+  - Andrés Montoya, 21552
+  - Fernanda Esquivel, 21542
+  - Francisco Castillo, 21562
+* Descripción: Lógica de la galaxia de la versión secuencial (un sf::CircleShape por estrella),
+  compartida por main.cpp y el estudio de escalabilidad.
+* Lenguaje: C++
+* Recursos: CLion, SFML
+* Historial:
+  - Creado el 17.10.2026 (extraído de main.cpp)
+*/
+
+#ifndef PARALLEL_SCREENSAVER_SEQUENTIAL_H
+#define PARALLEL_SCREENSAVER_SEQUENTIAL_H
+
+#include <SFML/Graphics.hpp>
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+
+// Generar los puntos en la galaxia (como círculos)
+inline void initGalaxy(std::vector<sf::CircleShape> &points, sf::Vector2f center, float maxRadius) {
+    const float angleIncrement = 0.70f; // Incremento de ángulo para los brazos espirales
+    const int numArms = 5;             // Número de brazos espirales
+    int numPoints = static_cast<int>(points.size());
+
+    for (int i = 0; i < numPoints; ++i) {
+        // Añadir un desplazamiento aleatorio al ángulo
+        float angleOffset = static_cast<float>(rand()) / RAND_MAX * 2 * 3.14159f;
+        float armAngle = (i * angleIncrement) + (2 * 3.14159f / numArms) * (rand() % numArms) + angleOffset * 0.5f;
+
+        // Calcular la posición inicial del punto
+        float radius = maxRadius * std::sqrt(static_cast<float>(rand() % 1000) / 1000.0f) * (0.9f + 0.2f * (static_cast<float>(rand()) / RAND_MAX));
+
+        // Calcular la posición del punto
+        float x = center.x + radius * std::cos(armAngle);
+        float y = center.y + radius * std::sin(armAngle);
+
+        // Crear un punto con un radio de 1 o 2 píxeles (círculos)
+        sf::CircleShape star((rand() % 10) < 3 ? 2.0f : 1.0f);
+        star.setPosition(x, y);
+
+        // Determinar el color basado en la distancia desde el centro
+        sf::Color color;
+        float normalizedRadius = radius / maxRadius;
+        if (normalizedRadius < 0.3f) {
+            // Amarillo oscuro hacia el centro
+            color = sf::Color(200, 200, 100 + static_cast<sf::Uint8>(55 * normalizedRadius / 0.3f));
+        } else if (normalizedRadius < 0.7f) {
+            // Azul oscuro en la zona media
+            color = sf::Color(
+                static_cast<sf::Uint8>(100 * (1 - (normalizedRadius - 0.3f) / 0.4f)),
+                static_cast<sf::Uint8>(100 + 55 * (normalizedRadius - 0.3f) / 0.4f),
+                200);
+        } else {
+            // Violeta oscuro en los bordes
+            color = sf::Color(80 + static_cast<sf::Uint8>(127 * (normalizedRadius - 0.7f) / 0.3f), 0, 180);
+        }
+
+        star.setFillColor(color);
+
+        // Añadir el punto al vector
+        points[i] = star;
+    }
+}
+
+// Actualizar la posición de los puntos (círculos de la galaxia)
+inline void updateGalaxy(std::vector<sf::CircleShape> &points, sf::Vector2f center, float maxRadius,
+                  float speed, float baseRotationSpeed) {
+    int numPoints = static_cast<int>(points.size());
+
+    for (int i = 0; i < numPoints; ++i) {
+        // Obtener la posición actual del punto
+        sf::Vector2f pos = points[i].getPosition();
+
+        // Calcular la distancia desde el centro
+        float dx = pos.x - center.x;
+        float dy = pos.y - center.y;
+
+        // Calcular el ángulo y radio del punto
+        float angle = std::atan2(dy, dx);
+        float radius = std::sqrt(dx * dx + dy * dy);
+
+        // Ajustar la velocidad de rotación en función de la distancia desde el centro
+        float rotationSpeed = baseRotationSpeed * (1.0f + (maxRadius - radius) / maxRadius);
+
+        // Rotar el punto más rápido si está más cerca del centro
+        angle += rotationSpeed;
+
+        float attractionSpeed = speed * (1.0f + (maxRadius - radius) / maxRadius);
+
+        // Mover el punto hacia el centro
+        radius -= attractionSpeed;
+
+        // Si el punto está demasiado cerca del centro, moverlo al borde de la galaxia
+        if (radius < 0) {
+            radius = maxRadius;
+
+            // Añadir alguna variación aleatoria al ángulo y radio
+            angle += static_cast<float>(rand()) / RAND_MAX * 0.2f - 0.1f;
+            radius *= 0.9f + static_cast<float>(rand()) / RAND_MAX * 0.2f;
+
+            // Establecer un nuevo color para el punto basado en la distancia
+            float normalizedRadius = radius / maxRadius;
+            sf::Color newColor;
+
+            // Usar un ciclo para cambiar los colores de forma continua
+            if (normalizedRadius < 0.3f) {
+                // Amarillo oscuro hacia el centro
+                newColor = sf::Color(200, 200, 100 + static_cast<sf::Uint8>(55 * normalizedRadius / 0.3f));
+            } else if (normalizedRadius < 0.7f) {
+                // Azul oscuro en la zona media
+                newColor = sf::Color(
+                    static_cast<sf::Uint8>(100 * (1 - (normalizedRadius - 0.3f) / 0.4f)),
+                    static_cast<sf::Uint8>(100 + 55 * (normalizedRadius - 0.3f) / 0.4f),
+                    200);
+            } else {
+                // Volver al color amarillo para continuar el ciclo en lugar de quedarse en violeta
+                float cycleRadius = fmod(normalizedRadius - 0.7f, 1.0f);  // Usar fmod para reiniciar el ciclo
+                if (cycleRadius < 0.3f) {
+                    newColor = sf::Color(200, 200, 100 + static_cast<sf::Uint8>(55 * cycleRadius / 0.3f));
+                } else if (cycleRadius < 0.7f) {
+                    newColor = sf::Color(
+                        static_cast<sf::Uint8>(100 * (1 - (cycleRadius - 0.3f) / 0.4f)),
+                        static_cast<sf::Uint8>(100 + 55 * (cycleRadius - 0.3f) / 0.4f),
+                        200);
+                } else {
+                    newColor = sf::Color(80 + static_cast<sf::Uint8>(127 * (cycleRadius - 0.7f) / 0.3f), 0, 180);
+                }
+            }
+
+            points[i].setFillColor(newColor);
+        }
+
+        // Calcular la nueva posición del punto
+        float x = center.x + radius * std::cos(angle);
+        float y = center.y + radius * std::sin(angle);
+
+        // Establecer la nueva posición del punto
+        points[i].setPosition(x, y);
+    }
+}
+
+#endif //PARALLEL_SCREENSAVER_SEQUENTIAL_H
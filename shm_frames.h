@@ -0,0 +1,426 @@
+/*
+* Nombre: shm_frames.h
+* Autores:
+  - Andrés Montoya, 21552
+  - Fernanda Esquivel, 21542
+  - Francisco Castillo, 21562
+* Descripción: Anillo de framebuffers en memoria compartida POSIX para publicar cada frame a otros
+  procesos (grabadores, compositores), que lo leen directamente del mapeo sin copiarlo. Cada ranura
+  lleva un número de secuencia y los lectores esperan frames nuevos con un futex.
+* Lenguaje: C++
+* Recursos: CLion
+* Historial:
+  - Creado el 17.10.2026
+*/
+
+#ifndef PARALLEL_SCREENSAVER_SHM_FRAMES_H
+#define PARALLEL_SCREENSAVER_SHM_FRAMES_H
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <new>
+#include <string>
+
+#ifdef __linux__
+#include <climits>
+#include <ctime>
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "software_raster.h"
+
+// Estructura del segmento (misma arquitectura en ambos procesos):
+//   ShmRingHeader (en la primera página de 4096 bytes)
+//   slotCount ranuras de slotStride bytes (múltiplo de 4096): ShmSlotHeader (64 bytes) seguido
+//   de width * height * 3 bytes RGB24
+const char kShmRingMagic[8] = {'G', 'A', 'L', 'F', 'R', 'M', 'S', '1'};
+const std::uint32_t kShmRingVersion = 1;
+const int kShmDefaultSlots = 3;
+
+struct ShmRingHeader {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t slotCount;
+    std::int32_t width, height;
+    std::uint64_t frameBytes;          // width * height * 3
+    std::uint64_t slotStride;          // Distancia entre ranuras
+    std::uint64_t slotOffset;          // Posición de la primera ranura desde el inicio
+    std::atomic<std::uint32_t> ready;  // 1 cuando el resto del encabezado ya es válido
+
+    alignas(64) std::atomic<std::uint64_t> published; // Último frame publicado (desde 1)
+    std::atomic<std::uint32_t> futexWord;             // Cambia con cada frame y al cerrar
+    std::atomic<std::uint32_t> waiters;               // Lectores dormidos en el futex
+    std::atomic<std::uint32_t> closed;                // El productor terminó
+
+    alignas(64) std::atomic<std::uint64_t> consumed;  // Frames leídos completos por los lectores
+    std::atomic<std::uint64_t> consumerDropped;       // Frames que los lectores no alcanzaron a ver
+};
+
+// Seqlock por ranura: mientras se escribe el frame n, sequence = 2n - 1; al terminar, 2n
+struct ShmSlotHeader {
+    std::atomic<std::uint64_t> sequence;
+    std::uint64_t frame;
+    std::uint64_t publishedNs;         // CLOCK_MONOTONIC al publicar, común a todos los procesos
+};
+
+static_assert(sizeof(ShmRingHeader) <= 4096, "el encabezado del anillo no cabe en una página");
+static_assert(sizeof(ShmSlotHeader) <= 64, "el encabezado de la ranura no cabe en 64 bytes");
+static_assert(std::atomic<std::uint64_t>::is_always_lock_free, "se necesitan atómicos sin candado entre procesos");
+
+namespace shm_detail {
+
+const std::uint64_t kSlotHeaderBytes = 64;
+const std::uint64_t kPageBytes = 4096;
+
+inline std::uint64_t pageAlign(std::uint64_t value) {
+    return (value + kPageBytes - 1) / kPageBytes * kPageBytes;
+}
+
+// POSIX pide que el nombre empiece con '/'
+inline std::string shmPath(const std::string &name) {
+    return name.empty() || name[0] == '/' ? name : "/" + name;
+}
+
+inline std::uint64_t monotonicNs() {
+#ifdef __linux__
+    timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return static_cast<std::uint64_t>(now.tv_sec) * 1000000000ull + static_cast<std::uint64_t>(now.tv_nsec);
+#else
+    return 0;
+#endif
+}
+
+#ifdef __linux__
+// Futex sin FUTEX_PRIVATE_FLAG: la palabra está en memoria compartida entre procesos
+inline void futexWait(std::atomic<std::uint32_t> &word, std::uint32_t expected, int timeoutMs) {
+    timespec timeout;
+    timeout.tv_sec = timeoutMs / 1000;
+    timeout.tv_nsec = static_cast<long>(timeoutMs % 1000) * 1000000L;
+    syscall(SYS_futex, reinterpret_cast<std::uint32_t *>(&word), FUTEX_WAIT, expected,
+            timeoutMs < 0 ? nullptr : &timeout, nullptr, 0);
+}
+
+inline void futexWakeAll(std::atomic<std::uint32_t> &word) {
+    syscall(SYS_futex, reinterpret_cast<std::uint32_t *>(&word), FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+}
+#endif
+
+} // namespace shm_detail
+
+// Publica frames en el anillo /name. Nunca espera a los lectores: si un lector va lento,
+// el productor sobrescribe la ranura más vieja y el lector cuenta esos frames como perdidos.
+class ShmFrameProducer {
+public:
+    ShmFrameProducer() = default;
+    ShmFrameProducer(const ShmFrameProducer &) = delete;
+    ShmFrameProducer &operator=(const ShmFrameProducer &) = delete;
+
+    ~ShmFrameProducer() {
+        close();
+    }
+
+    bool open(const std::string &name, int width, int height, int slots = kShmDefaultSlots) {
+        using namespace shm_detail;
+#ifdef __linux__
+        close();
+        frames_ = 0;
+        path_ = shmPath(name);
+        std::uint64_t frameBytes = static_cast<std::uint64_t>(width) * height * 3;
+        std::uint64_t slotStride = pageAlign(kSlotHeaderBytes + frameBytes);
+        length_ = static_cast<std::size_t>(kPageBytes + slotStride * slots);
+
+        // Un segmento con el mismo nombre de una ejecución anterior se reemplaza: los lectores
+        // que lo tengan mapeado ven que quedó cerrado
+        shm_unlink(path_.c_str());
+        int fd = shm_open(path_.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+        if (fd < 0) {
+            std::cerr << "No se pudo crear la memoria compartida " << path_ << "\n";
+            return false;
+        }
+        if (ftruncate(fd, static_cast<off_t>(length_)) != 0) {
+            std::cerr << "No se pudo reservar " << length_ << " bytes en " << path_ << "\n";
+            ::close(fd);
+            shm_unlink(path_.c_str());
+            return false;
+        }
+        void *address = mmap(nullptr, length_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (address == MAP_FAILED) {
+            std::cerr << "No se pudo mapear " << path_ << "\n";
+            shm_unlink(path_.c_str());
+            return false;
+        }
+        base_ = static_cast<char *>(address);
+
+        // ftruncate deja el segmento en ceros: basta construir los atómicos encima
+        header_ = new (base_) ShmRingHeader;
+        std::memcpy(header_->magic, kShmRingMagic, sizeof(kShmRingMagic));
+        header_->version = kShmRingVersion;
+        header_->slotCount = static_cast<std::uint32_t>(slots);
+        header_->width = width;
+        header_->height = height;
+        header_->frameBytes = frameBytes;
+        header_->slotStride = slotStride;
+        header_->slotOffset = kPageBytes;
+        for (int s = 0; s < slots; ++s) {
+            new (slot(s)) ShmSlotHeader;
+        }
+        header_->ready.store(1, std::memory_order_release);
+        return true;
+#else
+        (void)name;
+        (void)width;
+        (void)height;
+        (void)slots;
+        std::cerr << "La memoria compartida de frames solo está disponible en Linux\n";
+        return false;
+#endif
+    }
+
+    bool isOpen() const {
+        return header_ != nullptr;
+    }
+
+    // Copia el frame a la siguiente ranura y despierta a los lectores que esperan
+    bool publish(const Framebuffer &frame) {
+        if (!header_ || frame.width != header_->width || frame.height != header_->height) {
+            return false;
+        }
+        std::uint64_t n = ++frames_;
+        ShmSlotHeader *target = slot(static_cast<int>((n - 1) % header_->slotCount));
+        target->sequence.store(2 * n - 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        std::memcpy(pixels(target), frame.pixels.data(), static_cast<std::size_t>(header_->frameBytes));
+        target->frame = n;
+        target->publishedNs = shm_detail::monotonicNs();
+        target->sequence.store(2 * n, std::memory_order_release);
+
+        header_->published.store(n, std::memory_order_release);
+        header_->futexWord.fetch_add(1);
+#ifdef __linux__
+        if (header_->waiters.load() > 0) {
+            shm_detail::futexWakeAll(header_->futexWord);
+        }
+#endif
+        return true;
+    }
+
+    std::uint64_t published() const {
+        return frames_;
+    }
+
+    // Frames que los lectores leyeron completos hasta ahora
+    std::uint64_t consumed() const {
+        return header_ ? header_->consumed.load(std::memory_order_relaxed) : 0;
+    }
+
+    std::uint64_t consumerDropped() const {
+        return header_ ? header_->consumerDropped.load(std::memory_order_relaxed) : 0;
+    }
+
+    // Avisa a los lectores que no habrá más frames y borra el nombre. Los lectores conservan
+    // su mapeo hasta que lo cierren.
+    void close() {
+#ifdef __linux__
+        if (!header_) {
+            return;
+        }
+        header_->closed.store(1);
+        header_->futexWord.fetch_add(1);
+        shm_detail::futexWakeAll(header_->futexWord);
+        munmap(base_, length_);
+        shm_unlink(path_.c_str());
+#endif
+        header_ = nullptr;
+        base_ = nullptr;
+    }
+
+private:
+    ShmSlotHeader *slot(int index) const {
+        return reinterpret_cast<ShmSlotHeader *>(base_ + header_->slotOffset + header_->slotStride * index);
+    }
+
+    static std::uint8_t *pixels(ShmSlotHeader *slot) {
+        return reinterpret_cast<std::uint8_t *>(slot) + shm_detail::kSlotHeaderBytes;
+    }
+
+    std::string path_;
+    char *base_ = nullptr;
+    std::size_t length_ = 0;
+    ShmRingHeader *header_ = nullptr;
+    std::uint64_t frames_ = 0;
+};
+
+// Frame visto directamente en la memoria compartida. pixels sigue siendo válido solo mientras
+// el productor no vuelva a esa ranura; release() dice si eso pasó durante la lectura.
+struct ShmFrameView {
+    const std::uint8_t *pixels = nullptr;
+    int width = 0;
+    int height = 0;
+    std::uint64_t frame = 0;
+    std::uint64_t publishedNs = 0;
+    std::uint64_t skipped = 0;         // Frames publicados entre el anterior leído y este
+    const ShmSlotHeader *slot = nullptr;
+    std::uint64_t sequence = 0;
+};
+
+// Lector del anillo /name: siempre toma el frame más reciente
+class ShmFrameConsumer {
+public:
+    ShmFrameConsumer() = default;
+    ShmFrameConsumer(const ShmFrameConsumer &) = delete;
+    ShmFrameConsumer &operator=(const ShmFrameConsumer &) = delete;
+
+    ~ShmFrameConsumer() {
+#ifdef __linux__
+        if (base_) {
+            munmap(base_, length_);
+        }
+#endif
+    }
+
+    // Abre un anillo que ya existe. Devuelve falso si todavía no existe o no está listo,
+    // para que el llamador pueda reintentar.
+    bool open(const std::string &name) {
+        using namespace shm_detail;
+#ifdef __linux__
+        int fd = shm_open(shmPath(name).c_str(), O_RDWR, 0);
+        if (fd < 0) {
+            return false;
+        }
+        struct stat info;
+        if (fstat(fd, &info) != 0 || static_cast<std::uint64_t>(info.st_size) < kPageBytes) {
+            ::close(fd);
+            return false;
+        }
+        std::size_t length = static_cast<std::size_t>(info.st_size);
+        void *address = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (address == MAP_FAILED) {
+            return false;
+        }
+        ShmRingHeader *header = static_cast<ShmRingHeader *>(address);
+        if (!header->ready.load(std::memory_order_acquire) ||
+            std::memcmp(header->magic, kShmRingMagic, sizeof(kShmRingMagic)) != 0 ||
+            header->version != kShmRingVersion ||
+            header->slotOffset + header->slotStride * header->slotCount > length) {
+            munmap(address, length);
+            return false;
+        }
+        base_ = static_cast<char *>(address);
+        length_ = length;
+        header_ = header;
+        last_ = header_->published.load(std::memory_order_acquire);
+        return true;
+#else
+        (void)name;
+        return false;
+#endif
+    }
+
+    int width() const {
+        return header_->width;
+    }
+
+    int height() const {
+        return header_->height;
+    }
+
+    int slots() const {
+        return static_cast<int>(header_->slotCount);
+    }
+
+    // Espera hasta que haya un frame más nuevo que el último leído. Devuelve falso si se
+    // cumplió el plazo o si el productor cerró sin publicar más.
+    bool wait(int timeoutMs) {
+#ifdef __linux__
+        std::uint64_t deadline = shm_detail::monotonicNs() + static_cast<std::uint64_t>(timeoutMs) * 1000000ull;
+        while (true) {
+            std::uint32_t word = header_->futexWord.load();
+            if (header_->published.load(std::memory_order_acquire) > last_) {
+                return true;
+            }
+            if (header_->closed.load()) {
+                return false;
+            }
+            std::uint64_t now = shm_detail::monotonicNs();
+            if (now >= deadline) {
+                return false;
+            }
+            // Si el productor publica entre la lectura de word y la espera, la palabra ya
+            // cambió y el futex vuelve de inmediato
+            header_->waiters.fetch_add(1);
+            shm_detail::futexWait(header_->futexWord, word, static_cast<int>((deadline - now) / 1000000ull) + 1);
+            header_->waiters.fetch_sub(1);
+        }
+#else
+        (void)timeoutMs;
+        return false;
+#endif
+    }
+
+    bool closed() const {
+        return header_->closed.load() != 0 && header_->published.load(std::memory_order_acquire) <= last_;
+    }
+
+    // Toma el frame más reciente sin copiarlo. Devuelve falso si no hay uno nuevo o si el
+    // productor lo estaba escribiendo (en ese caso conviene volver a intentarlo).
+    bool acquire(ShmFrameView &view) {
+        std::uint64_t n = header_->published.load(std::memory_order_acquire);
+        if (n <= last_) {
+            return false;
+        }
+        const ShmSlotHeader *slot = slotOf(n);
+        std::uint64_t sequence = slot->sequence.load(std::memory_order_acquire);
+        if (sequence != 2 * n) {
+            return false;
+        }
+        view.pixels = reinterpret_cast<const std::uint8_t *>(slot) + shm_detail::kSlotHeaderBytes;
+        view.width = header_->width;
+        view.height = header_->height;
+        view.frame = slot->frame;
+        view.publishedNs = slot->publishedNs;
+        view.skipped = n - last_ - 1;
+        view.slot = slot;
+        view.sequence = sequence;
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot->sequence.load(std::memory_order_relaxed) != sequence) {
+            return false;
+        }
+        last_ = n;
+        return true;
+    }
+
+    // Termina de usar el frame. Devuelve falso si el productor empezó a sobrescribir la
+    // ranura mientras se leía: lo que se leyó puede estar mezclado con otro frame.
+    bool release(const ShmFrameView &view) {
+        std::atomic_thread_fence(std::memory_order_acquire);
+        bool intact = view.slot->sequence.load(std::memory_order_relaxed) == view.sequence;
+        if (intact) {
+            header_->consumed.fetch_add(1, std::memory_order_relaxed);
+        }
+        header_->consumerDropped.fetch_add(view.skipped + (intact ? 0 : 1), std::memory_order_relaxed);
+        return intact;
+    }
+
+private:
+    const ShmSlotHeader *slotOf(std::uint64_t frame) const {
+        return reinterpret_cast<const ShmSlotHeader *>(base_ + header_->slotOffset +
+                                                       header_->slotStride * ((frame - 1) % header_->slotCount));
+    }
+
+    char *base_ = nullptr;
+    std::size_t length_ = 0;
+    ShmRingHeader *header_ = nullptr;
+    std::uint64_t last_ = 0;
+};
+
+#endif //PARALLEL_SCREENSAVER_SHM_FRAMES_H
@@ -0,0 +1,297 @@
+/*
+* Nombre: simd_update.h
+* Autores:
+  - Andrés Montoya, 21552
+  - Fernanda Esquivel, 21542
+  - Francisco Castillo, 21562
+* Descripción: Actualización vectorizada de las estrellas (SSE2, AVX2 y AVX-512) elegida en tiempo de ejecución.
+* Lenguaje: C++
+* Recursos: CLion
+* Historial:
+  - Creado el 17.10.2026
+*/
+
+#ifndef PARALLEL_SCREENSAVER_SIMD_UPDATE_H
+#define PARALLEL_SCREENSAVER_SIMD_UPDATE_H
+
+#include <cstring>
+
+#include "star_update.h"
+
+// Los kernels vectoriales usan atributos de GCC/Clang para compilar cada función con su
+// propio conjunto de instrucciones; en otros compiladores solo queda la versión escalar.
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define GALAXY_HAS_X86_SIMD 1
+#include <immintrin.h>
+#endif
+
+enum class SimdLevel {
+    Auto,
+    Scalar,
+    SSE2,
+    AVX2,
+    AVX512
+};
+
+inline const char *simdLevelName(SimdLevel level) {
+    switch (level) {
+        case SimdLevel::Scalar: return "escalar";
+        case SimdLevel::SSE2: return "sse2";
+        case SimdLevel::AVX2: return "avx2";
+        case SimdLevel::AVX512: return "avx512";
+        default: return "auto";
+    }
+}
+
+inline bool parseSimdLevel(const char *name, SimdLevel &level) {
+    if (std::strcmp(name, "auto") == 0) level = SimdLevel::Auto;
+    else if (std::strcmp(name, "scalar") == 0 || std::strcmp(name, "escalar") == 0) level = SimdLevel::Scalar;
+    else if (std::strcmp(name, "sse2") == 0) level = SimdLevel::SSE2;
+    else if (std::strcmp(name, "avx2") == 0) level = SimdLevel::AVX2;
+    else if (std::strcmp(name, "avx512") == 0) level = SimdLevel::AVX512;
+    else return false;
+    return true;
+}
+
+// Mejor conjunto de instrucciones disponible en el procesador actual
+inline SimdLevel detectSimdLevel() {
+#ifdef GALAXY_HAS_X86_SIMD
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) return SimdLevel::AVX512;
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) return SimdLevel::AVX2;
+    if (__builtin_cpu_supports("sse2")) return SimdLevel::SSE2;
+#endif
+    return SimdLevel::Scalar;
+}
+
+// Resuelve Auto y baja de nivel si el procesador no soporta el pedido
+inline SimdLevel resolveSimdLevel(SimdLevel requested) {
+    SimdLevel best = detectSimdLevel();
+    if (requested == SimdLevel::Auto || static_cast<int>(requested) > static_cast<int>(best)) {
+        return best;
+    }
+    return requested;
+}
+
+#ifdef GALAXY_HAS_X86_SIMD
+
+// Constantes de la aproximación de seno y coseno (polinomios de Cephes en [-π/4, π/4]).
+// El ángulo se reduce por cuadrantes de π/2 con dos constantes (Cody-Waite).
+const float kTwoOverPi = 0.636619772f;
+const float kPiOverTwoHi = 1.5707963705062866f;
+const float kPiOverTwoLo = -4.371139000186243e-08f;
+const float kSinC1 = -1.6666654611e-1f;
+const float kSinC2 = 8.3321608736e-3f;
+const float kSinC3 = -1.9515295891e-4f;
+const float kCosC1 = 4.166664568298827e-2f;
+const float kCosC2 = -1.388731625493765e-3f;
+const float kCosC3 = 2.443315711809948e-5f;
+
+// ---------------------------------------------------------------- SSE2: 4 estrellas
+__attribute__((target("sse2")))
+inline void sincosSSE2(__m128 a, __m128 &s, __m128 &c) {
+    // Cuadrante más cercano; el ángulo es no negativo, así que truncar equivale a redondear hacia abajo
+    __m128i q = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(a, _mm_set1_ps(kTwoOverPi)), _mm_set1_ps(0.5f)));
+    __m128 qf = _mm_cvtepi32_ps(q);
+    __m128 y = _mm_sub_ps(a, _mm_mul_ps(qf, _mm_set1_ps(kPiOverTwoHi)));
+    y = _mm_sub_ps(y, _mm_mul_ps(qf, _mm_set1_ps(kPiOverTwoLo)));
+    __m128 z = _mm_mul_ps(y, y);
+
+    __m128 ps = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(kSinC3), z), _mm_set1_ps(kSinC2));
+    ps = _mm_add_ps(_mm_mul_ps(ps, z), _mm_set1_ps(kSinC1));
+    ps = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(ps, z), y), y);
+
+    __m128 pc = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(kCosC3), z), _mm_set1_ps(kCosC2));
+    pc = _mm_add_ps(_mm_mul_ps(pc, z), _mm_set1_ps(kCosC1));
+    pc = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(pc, z), z), _mm_sub_ps(_mm_set1_ps(1.0f), _mm_mul_ps(z, _mm_set1_ps(0.5f))));
+
+    // Cuadrantes impares intercambian seno y coseno; los signos dependen del cuadrante
+    __m128 swap = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(q, _mm_set1_epi32(1)), _mm_set1_epi32(1)));
+    __m128 sinSign = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(q, _mm_set1_epi32(2)), 30));
+    __m128 cosSign = _mm_castsi128_ps(_mm_slli_epi32(
+        _mm_and_si128(_mm_add_epi32(q, _mm_set1_epi32(1)), _mm_set1_epi32(2)), 30));
+    s = _mm_xor_ps(_mm_or_ps(_mm_and_ps(swap, pc), _mm_andnot_ps(swap, ps)), sinSign);
+    c = _mm_xor_ps(_mm_or_ps(_mm_and_ps(swap, ps), _mm_andnot_ps(swap, pc)), cosSign);
+}
+
+__attribute__((target("sse2")))
+inline void updateStarsSSE2(StarStore &stars, const GalaxyParams &params, int begin, int end) {
+    const __m128 invRadius = _mm_set1_ps(1.0f / params.maxRadius);
+    const __m128 two = _mm_set1_ps(2.0f);
+    const __m128 rotation = _mm_set1_ps(params.baseRotationSpeed);
+    const __m128 speed = _mm_set1_ps(params.speed);
+    const __m128 twoPi = _mm_set1_ps(kTwoPi);
+    const __m128 centerX = _mm_set1_ps(params.centerX);
+    const __m128 centerY = _mm_set1_ps(params.centerY);
+
+    int i = begin;
+    for (; i + 4 <= end; i += 4) {
+        __m128 radius = _mm_loadu_ps(&stars.radius[i]);
+        __m128 angle = _mm_loadu_ps(&stars.angle[i]);
+
+        // 1 + (R - r) / R = 2 - r / R
+        __m128 factor = _mm_sub_ps(two, _mm_mul_ps(radius, invRadius));
+        angle = _mm_add_ps(angle, _mm_mul_ps(rotation, factor));
+        radius = _mm_sub_ps(radius, _mm_mul_ps(speed, factor));
+        angle = _mm_sub_ps(angle, _mm_and_ps(_mm_cmpge_ps(angle, twoPi), twoPi));
+
+        __m128 s, c;
+        sincosSSE2(angle, s, c);
+        _mm_storeu_ps(&stars.angle[i], angle);
+        _mm_storeu_ps(&stars.radius[i], radius);
+        _mm_storeu_ps(&stars.x[i], _mm_add_ps(centerX, _mm_mul_ps(radius, c)));
+        _mm_storeu_ps(&stars.y[i], _mm_add_ps(centerY, _mm_mul_ps(radius, s)));
+
+        // Solo las estrellas que cruzaron el centro pasan por la reaparición escalar
+        int respawn = _mm_movemask_ps(_mm_cmplt_ps(radius, _mm_setzero_ps()));
+        while (respawn) {
+            int lane = __builtin_ctz(respawn);
+            respawnStar(stars, params, i + lane);
+            respawn &= respawn - 1;
+        }
+    }
+    updateStarsScalar(stars, params, i, end);
+}
+
+// ---------------------------------------------------------------- AVX2: 8 estrellas
+__attribute__((target("avx2,fma")))
+inline void sincosAVX2(__m256 a, __m256 &s, __m256 &c) {
+    __m256i q = _mm256_cvttps_epi32(_mm256_fmadd_ps(a, _mm256_set1_ps(kTwoOverPi), _mm256_set1_ps(0.5f)));
+    __m256 qf = _mm256_cvtepi32_ps(q);
+    __m256 y = _mm256_fnmadd_ps(qf, _mm256_set1_ps(kPiOverTwoHi), a);
+    y = _mm256_fnmadd_ps(qf, _mm256_set1_ps(kPiOverTwoLo), y);
+    __m256 z = _mm256_mul_ps(y, y);
+
+    __m256 ps = _mm256_fmadd_ps(_mm256_set1_ps(kSinC3), z, _mm256_set1_ps(kSinC2));
+    ps = _mm256_fmadd_ps(ps, z, _mm256_set1_ps(kSinC1));
+    ps = _mm256_fmadd_ps(_mm256_mul_ps(ps, z), y, y);
+
+    __m256 pc = _mm256_fmadd_ps(_mm256_set1_ps(kCosC3), z, _mm256_set1_ps(kCosC2));
+    pc = _mm256_fmadd_ps(pc, z, _mm256_set1_ps(kCosC1));
+    pc = _mm256_fmadd_ps(_mm256_mul_ps(pc, z), z, _mm256_fnmadd_ps(z, _mm256_set1_ps(0.5f), _mm256_set1_ps(1.0f)));
+
+    __m256 swap = _mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_and_si256(q, _mm256_set1_epi32(1)), _mm256_set1_epi32(1)));
+    __m256 sinSign = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(q, _mm256_set1_epi32(2)), 30));
+    __m256 cosSign = _mm256_castsi256_ps(_mm256_slli_epi32(
+        _mm256_and_si256(_mm256_add_epi32(q, _mm256_set1_epi32(1)), _mm256_set1_epi32(2)), 30));
+    s = _mm256_xor_ps(_mm256_blendv_ps(ps, pc, swap), sinSign);
+    c = _mm256_xor_ps(_mm256_blendv_ps(pc, ps, swap), cosSign);
+}
+
+__attribute__((target("avx2,fma")))
+inline void updateStarsAVX2(StarStore &stars, const GalaxyParams &params, int begin, int end) {
+    const __m256 invRadius = _mm256_set1_ps(1.0f / params.maxRadius);
+    const __m256 two = _mm256_set1_ps(2.0f);
+    const __m256 rotation = _mm256_set1_ps(params.baseRotationSpeed);
+    const __m256 speed = _mm256_set1_ps(params.speed);
+    const __m256 twoPi = _mm256_set1_ps(kTwoPi);
+    const __m256 centerX = _mm256_set1_ps(params.centerX);
+    const __m256 centerY = _mm256_set1_ps(params.centerY);
+
+    int i = begin;
+    for (; i + 8 <= end; i += 8) {
+        __m256 radius = _mm256_loadu_ps(&stars.radius[i]);
+        __m256 angle = _mm256_loadu_ps(&stars.angle[i]);
+
+        __m256 factor = _mm256_fnmadd_ps(radius, invRadius, two);
+        angle = _mm256_fmadd_ps(rotation, factor, angle);
+        radius = _mm256_fnmadd_ps(speed, factor, radius);
+        angle = _mm256_sub_ps(angle, _mm256_and_ps(_mm256_cmp_ps(angle, twoPi, _CMP_GE_OQ), twoPi));
+
+        __m256 s, c;
+        sincosAVX2(angle, s, c);
+        _mm256_storeu_ps(&stars.angle[i], angle);
+        _mm256_storeu_ps(&stars.radius[i], radius);
+        _mm256_storeu_ps(&stars.x[i], _mm256_fmadd_ps(radius, c, centerX));
+        _mm256_storeu_ps(&stars.y[i], _mm256_fmadd_ps(radius, s, centerY));
+
+        int respawn = _mm256_movemask_ps(_mm256_cmp_ps(radius, _mm256_setzero_ps(), _CMP_LT_OQ));
+        while (respawn) {
+            int lane = __builtin_ctz(respawn);
+            respawnStar(stars, params, i + lane);
+            respawn &= respawn - 1;
+        }
+    }
+    updateStarsScalar(stars, params, i, end);
+}
+
+// ---------------------------------------------------------------- AVX-512: 16 estrellas
+__attribute__((target("avx512f")))
+inline void sincosAVX512(__m512 a, __m512 &s, __m512 &c) {
+    __m512i q = _mm512_cvttps_epi32(_mm512_fmadd_ps(a, _mm512_set1_ps(kTwoOverPi), _mm512_set1_ps(0.5f)));
+    __m512 qf = _mm512_cvtepi32_ps(q);
+    __m512 y = _mm512_fnmadd_ps(qf, _mm512_set1_ps(kPiOverTwoHi), a);
+    y = _mm512_fnmadd_ps(qf, _mm512_set1_ps(kPiOverTwoLo), y);
+    __m512 z = _mm512_mul_ps(y, y);
+
+    __m512 ps = _mm512_fmadd_ps(_mm512_set1_ps(kSinC3), z, _mm512_set1_ps(kSinC2));
+    ps = _mm512_fmadd_ps(ps, z, _mm512_set1_ps(kSinC1));
+    ps = _mm512_fmadd_ps(_mm512_mul_ps(ps, z), y, y);
+
+    __m512 pc = _mm512_fmadd_ps(_mm512_set1_ps(kCosC3), z, _mm512_set1_ps(kCosC2));
+    pc = _mm512_fmadd_ps(pc, z, _mm512_set1_ps(kCosC1));
+    pc = _mm512_fmadd_ps(_mm512_mul_ps(pc, z), z, _mm512_fnmadd_ps(z, _mm512_set1_ps(0.5f), _mm512_set1_ps(1.0f)));
+
+    __mmask16 swap = _mm512_test_epi32_mask(q, _mm512_set1_epi32(1));
+    __m512i sinSign = _mm512_slli_epi32(_mm512_and_si512(q, _mm512_set1_epi32(2)), 30);
+    __m512i cosSign = _mm512_slli_epi32(_mm512_and_si512(_mm512_add_epi32(q, _mm512_set1_epi32(1)), _mm512_set1_epi32(2)), 30);
+    s = _mm512_castsi512_ps(_mm512_xor_si512(_mm512_castps_si512(_mm512_mask_blend_ps(swap, ps, pc)), sinSign));
+    c = _mm512_castsi512_ps(_mm512_xor_si512(_mm512_castps_si512(_mm512_mask_blend_ps(swap, pc, ps)), cosSign));
+}
+
+__attribute__((target("avx512f")))
+inline void updateStarsAVX512(StarStore &stars, const GalaxyParams &params, int begin, int end) {
+    const __m512 invRadius = _mm512_set1_ps(1.0f / params.maxRadius);
+    const __m512 two = _mm512_set1_ps(2.0f);
+    const __m512 rotation = _mm512_set1_ps(params.baseRotationSpeed);
+    const __m512 speed = _mm512_set1_ps(params.speed);
+    const __m512 twoPi = _mm512_set1_ps(kTwoPi);
+    const __m512 centerX = _mm512_set1_ps(params.centerX);
+    const __m512 centerY = _mm512_set1_ps(params.centerY);
+
+    int i = begin;
+    for (; i + 16 <= end; i += 16) {
+        __m512 radius = _mm512_loadu_ps(&stars.radius[i]);
+        __m512 angle = _mm512_loadu_ps(&stars.angle[i]);
+
+        __m512 factor = _mm512_fnmadd_ps(radius, invRadius, two);
+        angle = _mm512_fmadd_ps(rotation, factor, angle);
+        radius = _mm512_fnmadd_ps(speed, factor, radius);
+        angle = _mm512_mask_sub_ps(angle, _mm512_cmp_ps_mask(angle, twoPi, _CMP_GE_OQ), angle, twoPi);
+
+        __m512 s, c;
+        sincosAVX512(angle, s, c);
+        _mm512_storeu_ps(&stars.angle[i], angle);
+        _mm512_storeu_ps(&stars.radius[i], radius);
+        _mm512_storeu_ps(&stars.x[i], _mm512_fmadd_ps(radius, c, centerX));
+        _mm512_storeu_ps(&stars.y[i], _mm512_fmadd_ps(radius, s, centerY));
+
+        unsigned respawn = _mm512_cmp_ps_mask(radius, _mm512_setzero_ps(), _CMP_LT_OQ);
+        while (respawn) {
+            int lane = __builtin_ctz(respawn);
+            respawnStar(stars, params, i + lane);
+            respawn &= respawn - 1;
+        }
+    }
+    updateStarsScalar(stars, params, i, end);
+}
+
+#endif // GALAXY_HAS_X86_SIMD
+
+typedef void (*UpdateKernel)(StarStore &, const GalaxyParams &, int, int);
+
+// Kernel de actualización para un nivel ya resuelto con resolveSimdLevel
+inline UpdateKernel selectUpdateKernel(SimdLevel level) {
+#ifdef GALAXY_HAS_X86_SIMD
+    switch (level) {
+        case SimdLevel::AVX512: return updateStarsAVX512;
+        case SimdLevel::AVX2: return updateStarsAVX2;
+        case SimdLevel::SSE2: return updateStarsSSE2;
+        default: break;
+    }
+#endif
+    (void) level;
+    return updateStarsScalar;
+}
+
+#endif //PARALLEL_SCREENSAVER_SIMD_UPDATE_H
@@ -0,0 +1,318 @@
+/*
+* Nombre: snapshot.h
+* Autores:
+  - Andrés Montoya, 21552
+  - Fernanda Esquivel, 21542
+  - Francisco Castillo, 21562
+* Descripción: Formato binario de snapshots de la galaxia (encabezado + columnas alineadas) que se
+  cargan mapeando el archivo en memoria, sin copiarlo.
+* Lenguaje: C++
+* Recursos: CLion
+* Historial:
+  - Creado el 17.10.2026
+  - Modificado el 17.10.2026 (se guarda siempre en el orden de generación)
+  - Modificado el 17.10.2026 (se validan la cantidad de estrellas, las paletas y los tamaños)
+*/
+
+#ifndef PARALLEL_SCREENSAVER_SNAPSHOT_H
+#define PARALLEL_SCREENSAVER_SNAPSHOT_H
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <string>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "spatial_order.h"
+#include "star_store.h"
+#include "star_update.h"
+
+// Estructura del archivo (little endian):
+//   SnapshotHeader (128 bytes)
+//   radius, angle, pointSize, palette, generation, x, y: cada columna empieza en un múltiplo
+//   de 64 bytes y ocupa count * sizeof(elemento)
+const char kSnapshotMagic[8] = {'G', 'A', 'L', 'A', 'X', 'S', 'N', 'P'};
+const std::uint32_t kSnapshotVersion = 1;
+const std::uint32_t kSnapshotByteOrder = 0x01020304;
+const std::uint64_t kSnapshotAlignment = 64;
+const int kSnapshotColumns = 7;
+
+struct SnapshotHeader {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t byteOrder;           // Se lee distinto si el archivo viene de otra arquitectura
+    std::uint64_t count;               // Número de estrellas
+    std::uint64_t seed;                // Semilla de los números aleatorios
+    float centerX, centerY;            // GalaxyParams con que se generó
+    float maxRadius, speed, baseRotationSpeed;
+    std::uint32_t columnCount;
+    std::uint64_t offsets[kSnapshotColumns]; // Posición de cada columna desde el inicio del archivo
+    std::uint64_t reserved[2];
+};
+
+static_assert(sizeof(SnapshotHeader) == 128, "El encabezado del snapshot debe medir 128 bytes");
+
+namespace snapshot_detail {
+
+inline std::uint64_t alignUp(std::uint64_t value) {
+    return (value + kSnapshotAlignment - 1) / kSnapshotAlignment * kSnapshotAlignment;
+}
+
+// Tamaño de los elementos de cada columna, en el orden del archivo
+inline std::uint64_t elementSize(int column) {
+    return column == 3 ? sizeof(std::uint16_t) : 4;
+}
+
+inline bool writeColumn(std::FILE *file, std::uint64_t &position, std::uint64_t offset, const void *data,
+                        std::uint64_t bytes) {
+    static const char zeros[kSnapshotAlignment] = {};
+    if (offset > position && std::fwrite(zeros, 1, offset - position, file) != offset - position) {
+        return false;
+    }
+    position = offset + bytes;
+    return bytes == 0 || std::fwrite(data, 1, bytes, file) == bytes;
+}
+
+#ifndef _WIN32
+// Archivo mapeado con MAP_PRIVATE: las escrituras de la simulación van a páginas privadas
+// del proceso y el archivo no cambia
+struct FileMapping : MappedRegion {
+    void *address = nullptr;
+    std::size_t length = 0;
+
+    ~FileMapping() override {
+        if (address) {
+            munmap(address, length);
+        }
+    }
+};
+#endif
+
+} // namespace snapshot_detail
+
+// Guarda el estado en path. Se escribe en un archivo temporal y se renombra al final, así
+// un checkpoint interrumpido nunca deja un snapshot a medias.
+inline bool saveSnapshot(const std::string &path, const StarStore &stars, const GalaxyParams &params) {
+    using namespace snapshot_detail;
+    // El formato no guarda stars.id: unas estrellas en orden espacial se guardan en el de generación
+    if (stars.id.size() != 0) {
+        StarStore generationOrder = stars;
+        restoreGenerationOrder(generationOrder);
+        return saveSnapshot(path, generationOrder, params);
+    }
+    SnapshotHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, kSnapshotMagic, sizeof(header.magic));
+    header.version = kSnapshotVersion;
+    header.byteOrder = kSnapshotByteOrder;
+    header.count = stars.count();
+    header.seed = params.seed;
+    header.centerX = params.centerX;
+    header.centerY = params.centerY;
+    header.maxRadius = params.maxRadius;
+    header.speed = params.speed;
+    header.baseRotationSpeed = params.baseRotationSpeed;
+    header.columnCount = kSnapshotColumns;
+
+    const void *columns[kSnapshotColumns] = {stars.radius.data(), stars.angle.data(), stars.pointSize.data(),
+                                             stars.palette.data(), stars.generation.data(),
+                                             stars.x.data(), stars.y.data()};
+    std::uint64_t offset = alignUp(sizeof(header));
+    for (int c = 0; c < kSnapshotColumns; ++c) {
+        header.offsets[c] = offset;
+        offset = alignUp(offset + header.count * elementSize(c));
+    }
+
+    std::string temporary = path + ".tmp";
+    std::FILE *file = std::fopen(temporary.c_str(), "wb");
+    if (!file) {
+        std::cerr << "No se pudo crear " << temporary << "\n";
+        return false;
+    }
+    bool ok = std::fwrite(&header, sizeof(header), 1, file) == 1;
+    std::uint64_t position = sizeof(header);
+    for (int c = 0; c < kSnapshotColumns && ok; ++c) {
+        ok = writeColumn(file, position, header.offsets[c], columns[c], header.count * elementSize(c));
+    }
+    ok = std::fclose(file) == 0 && ok;
+#ifdef _WIN32
+    std::remove(path.c_str()); // En Windows rename no reemplaza un archivo existente
+#endif
+    if (!ok || std::rename(temporary.c_str(), path.c_str()) != 0) {
+        std::cerr << "No se pudo escribir el snapshot " << path << "\n";
+        std::remove(temporary.c_str());
+        return false;
+    }
+    return true;
+}
+
+// Revisa que el encabezado sea de esta versión, que la cantidad de estrellas esté en
+// [minCount, maxCount] (los mismos límites de --points) y que todas las columnas quepan en el archivo
+inline bool validSnapshotHeader(const SnapshotHeader &header, std::uint64_t fileSize, std::uint64_t minCount,
+                                std::uint64_t maxCount, const std::string &path) {
+    using namespace snapshot_detail;
+    if (std::memcmp(header.magic, kSnapshotMagic, sizeof(header.magic)) != 0) {
+        std::cerr << path << " no es un snapshot de la galaxia\n";
+        return false;
+    }
+    if (header.version != kSnapshotVersion || header.byteOrder != kSnapshotByteOrder ||
+        header.columnCount != kSnapshotColumns) {
+        std::cerr << path << ": version " << header.version << " u orden de bytes no soportados\n";
+        return false;
+    }
+    if (header.count < minCount || header.count > maxCount) {
+        std::cerr << path << ": " << header.count << " estrellas; deben ser entre " << minCount << " y "
+                  << maxCount << " (o usar --large)\n";
+        return false;
+    }
+    for (int c = 0; c < kSnapshotColumns; ++c) {
+        std::uint64_t bytes = header.count * elementSize(c);
+        if (header.offsets[c] % kSnapshotAlignment != 0 || header.count > (1ULL << 40) ||
+            header.offsets[c] > fileSize || bytes > fileSize - header.offsets[c]) {
+            std::cerr << path << ": snapshot truncado o corrupto\n";
+            return false;
+        }
+    }
+    return true;
+}
+
+// Los índices de paleta y los tamaños se usan sin revisar al dibujar: un índice fuera de la
+// tabla leería fuera de ella. Solo se leen estas dos columnas (6 bytes por estrella).
+inline bool validSnapshotStars(const StarStore &stars, const std::string &path) {
+    for (std::size_t i = 0; i < stars.count(); ++i) {
+        float size = stars.pointSize[i];
+        if (stars.palette[i] >= kPaletteLevels || (size != 1.0f && size != 2.0f)) {
+            std::cerr << path << ": la estrella " << i << " tiene un color o un tamano invalido\n";
+            return false;
+        }
+    }
+    return true;
+}
+
+// Carga un snapshot de entre minCount y maxCount estrellas. En POSIX el archivo se mapea en
+// memoria y las columnas de stars lo ven directamente; además de mapearlo solo se leen los
+// colores y tamaños para validarlos, el resto de las páginas se leen al usarlas. En Windows
+// se lee completo.
+inline bool loadSnapshot(const std::string &path, StarStore &stars, GalaxyParams &params,
+                         std::uint64_t minCount, std::uint64_t maxCount) {
+    using namespace snapshot_detail;
+    SnapshotHeader header;
+#ifndef _WIN32
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        std::cerr << "No se pudo abrir el snapshot " << path << "\n";
+        return false;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || static_cast<std::uint64_t>(info.st_size) < sizeof(header)) {
+        std::cerr << path << ": snapshot truncado o corrupto\n";
+        close(fd);
+        return false;
+    }
+    std::shared_ptr<FileMapping> mapping = std::make_shared<FileMapping>();
+    mapping->length = static_cast<std::size_t>(info.st_size);
+    void *address = mmap(nullptr, mapping->length, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (address == MAP_FAILED) {
+        std::cerr << "No se pudo mapear el snapshot " << path << "\n";
+        return false;
+    }
+    mapping->address = address;
+    std::memcpy(&header, address, sizeof(header));
+    if (!validSnapshotHeader(header, mapping->length, minCount, maxCount, path)) {
+        return false;
+    }
+
+    char *base = static_cast<char *>(address);
+    std::size_t count = static_cast<std::size_t>(header.count);
+    stars.radius.view(reinterpret_cast<float *>(base + header.offsets[0]), count, mapping);
+    stars.angle.view(reinterpret_cast<float *>(base + header.offsets[1]), count, mapping);
+    stars.pointSize.view(reinterpret_cast<float *>(base + header.offsets[2]), count, mapping);
+    stars.palette.view(reinterpret_cast<std::uint16_t *>(base + header.offsets[3]), count, mapping);
+    stars.generation.view(reinterpret_cast<std::uint32_t *>(base + header.offsets[4]), count, mapping);
+    stars.x.view(reinterpret_cast<float *>(base + header.offsets[5]), count, mapping);
+    stars.y.view(reinterpret_cast<float *>(base + header.offsets[6]), count, mapping);
+#else
+    std::FILE *file = std::fopen(path.c_str(), "rb");
+    if (!file) {
+        std::cerr << "No se pudo abrir el snapshot " << path << "\n";
+        return false;
+    }
+    std::fseek(file, 0, SEEK_END);
+    std::uint64_t fileSize = static_cast<std::uint64_t>(_ftelli64(file));
+    std::fseek(file, 0, SEEK_SET);
+    if (std::fread(&header, sizeof(header), 1, file) != 1 || !validSnapshotHeader(header, fileSize, minCount, maxCount, path)) {
+        std::fclose(file);
+        return false;
+    }
+    stars.resize(static_cast<std::size_t>(header.count));
+    void *columns[kSnapshotColumns] = {stars.radius.data(), stars.angle.data(), stars.pointSize.data(),
+                                       stars.palette.data(), stars.generation.data(),
+                                       stars.x.data(), stars.y.data()};
+    bool ok = true;
+    for (int c = 0; c < kSnapshotColumns && ok; ++c) {
+        std::uint64_t bytes = header.count * elementSize(c);
+        ok = _fseeki64(file, static_cast<long long>(header.offsets[c]), SEEK_SET) == 0 &&
+             std::fread(columns[c], 1, bytes, file) == bytes;
+    }
+    std::fclose(file);
+    if (!ok) {
+        std::cerr << path << ": snapshot truncado o corrupto\n";
+        return false;
+    }
+#endif
+    if (!validSnapshotStars(stars, path)) {
+        stars = StarStore();
+        return false;
+    }
+
+    params.seed = header.seed;
+    params.centerX = header.centerX;
+    params.centerY = header.centerY;
+    params.maxRadius = header.maxRadius;
+    params.speed = header.speed;
+    params.baseRotationSpeed = header.baseRotationSpeed;
+    return true;
+}
+
+// Guarda el estado cada cierto tiempo (y al final) para poder retomar la simulación
+class SnapshotCheckpoint {
+public:
+    SnapshotCheckpoint(const std::string &path, double intervalSeconds)
+        : path_(path), interval_(intervalSeconds), last_(std::chrono::steady_clock::now()) {}
+
+    bool enabled() const {
+        return !path_.empty();
+    }
+
+    void maybeSave(const StarStore &stars, const GalaxyParams &params) {
+        if (path_.empty() || interval_ <= 0.0) {
+            return;
+        }
+        auto now = std::chrono::steady_clock::now();
+        if (std::chrono::duration<double>(now - last_).count() >= interval_) {
+            saveSnapshot(path_, stars, params);
+            last_ = now;
+        }
+    }
+
+    bool save(const StarStore &stars, const GalaxyParams &params) {
+        return path_.empty() || saveSnapshot(path_, stars, params);
+    }
+
+private:
+    std::string path_;
+    double interval_;
+    std::chrono::steady_clock::time_point last_;
+};
+
+#endif //PARALLEL_SCREENSAVER_SNAPSHOT_H
@@ -0,0 +1,445 @@
+/*
+* Nombre: software_raster.h
+* Autores:
+  - Andrés Montoya, 21552
+  - Fernanda Esquivel, 21542
+  - Francisco Castillo, 21562
+* Descripción: Dibujo de la galaxia en CPU por mosaicos (un hilo por mosaico) y escritura de frames a disco.
+* Lenguaje: C++
+* Recursos: CLion
+* Historial:
+  - Creado el 17.10.2026
+  - Modificado el 17.10.2026 (política paralela intercambiable, para compartir el pool entre galaxias)
+  - Modificado el 17.10.2026 (cobertura por píxel para componer partes de la galaxia de varios procesos)
+  - Modificado el 17.10.2026 (se valida el patrón de --output antes de pasarlo a snprintf)
+  - Modificado el 17.10.2026 (con --spatial-order las estrellas superpuestas se resuelven por id)
+*/
+
+#ifndef PARALLEL_SCREENSAVER_SOFTWARE_RASTER_H
+#define PARALLEL_SCREENSAVER_SOFTWARE_RASTER_H
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <omp.h>
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#endif
+
+#include "extra_stars.h"
+#include "palette.h"
+#include "parallel_backend.h"
+#include "star_store.h"
+
+// Imagen RGB de 8 bits por canal, fila por fila
+struct Framebuffer {
+    int width = 0;
+    int height = 0;
+    std::vector<std::uint8_t> pixels;
+
+    void resize(int w, int h) {
+        width = w;
+        height = h;
+        pixels.assign(static_cast<std::size_t>(w) * h * 3, 0);
+    }
+};
+
+// Llama a f(px, py) por cada píxel del rectángulo [x0, x1) x [y0, y1) que cubre el círculo de
+// una estrella: cuenta un píxel si su centro cae dentro del círculo de radio r
+template <typename F>
+inline void forEachCirclePixel(float cx, float cy, float r, int x0, int y0, int x1, int y1, F f) {
+    int px0 = std::max(x0, static_cast<int>(std::floor(cx - r)));
+    int px1 = std::min(x1 - 1, static_cast<int>(std::floor(cx + r)));
+    int py0 = std::max(y0, static_cast<int>(std::floor(cy - r)));
+    int py1 = std::min(y1 - 1, static_cast<int>(std::floor(cy + r)));
+    for (int py = py0; py <= py1; ++py) {
+        float dy = py + 0.5f - cy;
+        for (int px = px0; px <= px1; ++px) {
+            float dx = px + 0.5f - cx;
+            if (dx * dx + dy * dy <= r * r) {
+                f(px, py);
+            }
+        }
+    }
+}
+
+// Cobertura de una parte de la galaxia: por píxel, (índice global + 1) << 16 | índice de color
+// de la última estrella que lo pinta, o 0 si ninguna. Como cada estrella tapa a las de índice
+// menor, el máximo por píxel entre las partes de varios procesos es la estrella que se ve en
+// la galaxia completa (MPI_MAX en la reducción).
+inline std::uint64_t coverageValue(std::uint32_t globalIndex, std::uint16_t color) {
+    return (static_cast<std::uint64_t>(globalIndex) + 1) << 16 | color;
+}
+
+// Mezcla en blanco, según su opacidad, el polígono de 10 vértices de la k-ésima estrella
+// adicional, solo dentro del rectángulo [x0, x1) x [y0, y1)
+inline void blendExtraStar(const ExtraStarPool &extraStars, std::size_t k, int x0, int y0, int x1, int y1,
+                           Framebuffer &frame) {
+    const StarGeometry &geometry = extraStarGeometry();
+    float sx = extraStars.x(k);
+    float sy = extraStars.y(k);
+    int alpha = extraStars.alpha(k);
+    int px0 = std::max(x0, static_cast<int>(std::floor(sx + geometry.minX)));
+    int px1 = std::min(x1 - 1, static_cast<int>(std::floor(sx + geometry.maxX)));
+    int py0 = std::max(y0, static_cast<int>(std::floor(sy + geometry.minY)));
+    int py1 = std::min(y1 - 1, static_cast<int>(std::floor(sy + geometry.maxY)));
+    for (int py = py0; py <= py1; ++py) {
+        for (int px = px0; px <= px1; ++px) {
+            if (!geometry.contains(px + 0.5f - sx, py + 0.5f - sy)) {
+                continue;
+            }
+            std::uint8_t *p = &frame.pixels[(static_cast<std::size_t>(py) * frame.width + px) * 3];
+            for (int c = 0; c < 3; ++c) {
+                p[c] = static_cast<std::uint8_t>((255 * alpha + p[c] * (255 - alpha)) / 255);
+            }
+        }
+    }
+}
+
+// Rasterizador por mosaicos. Primero reparte las estrellas en los mosaicos que tocan y
+// después cada hilo dibuja mosaicos completos, así ningún par de hilos escribe el mismo píxel.
+class TiledRasterizer {
+public:
+    explicit TiledRasterizer(int width = 800, int height = 800, int tileSize = 64)
+        : width_(width), height_(height), tileSize_(tileSize) {
+        tilesX_ = (width + tileSize - 1) / tileSize;
+        tilesY_ = (height + tileSize - 1) / tileSize;
+        tileStart_.resize(tilesX_ * tilesY_ + 1);
+    }
+
+    int tileCount() const {
+        return tilesX_ * tilesY_;
+    }
+
+    // Por defecto los mosaicos se reparten con OpenMP dinámico; dentro de un hilo del pool
+    // (varias galaxias en un proceso) se usa el pool para no crear otro equipo de OpenMP
+    void setPolicy(const ParallelPolicy &policy) {
+        policy_ = policy;
+    }
+
+    void render(const StarStore &stars, const Palette &palette, const ExtraStarPool &extraStars,
+                Framebuffer &frame) {
+        if (frame.width != width_ || frame.height != height_) {
+            frame.resize(width_, height_);
+        }
+        binStars(stars);
+        binExtraStars(extraStars);
+        if (stars.id.size() != 0) {
+            drawnId_.resize(static_cast<std::size_t>(width_) * height_);
+        }
+
+        parallelFor(policy_, 0, tileCount(), [&](int tile) {
+            renderTile(tile, stars, palette, extraStars, frame);
+        });
+    }
+
+    // Como render, pero escribe la cobertura de las estrellas (ver coverageValue) en lugar de
+    // colores; firstStar es el índice global de la estrella 0. Sin estrellas adicionales.
+    void renderCoverage(const StarStore &stars, std::uint32_t firstStar, const Palette &palette,
+                        std::vector<std::uint64_t> &coverage) {
+        coverage.resize(static_cast<std::size_t>(width_) * height_);
+        binStars(stars);
+
+        parallelFor(policy_, 0, tileCount(), [&](int tile) {
+            int x0, y0, x1, y1;
+            tileBounds(tile, x0, y0, x1, y1);
+            for (int py = y0; py < y1; ++py) {
+                std::uint64_t *row = &coverage[static_cast<std::size_t>(py) * width_ + x0];
+                std::fill(row, row + (x1 - x0), std::uint64_t(0));
+            }
+            for (int b = tileStart_[tile]; b < tileStart_[tile + 1]; ++b) {
+                int i = binned_[b];
+                float r = stars.pointSize[i];
+                std::uint64_t value = coverageValue(firstStar + stars.idOf(i), palette.indexOf(stars, i));
+                forEachCirclePixel(stars.x[i] + r, stars.y[i] + r, r, x0, y0, x1, y1, [&](int px, int py) {
+                    coverage[static_cast<std::size_t>(py) * width_ + px] = value;
+                });
+            }
+        });
+    }
+
+private:
+    // Caja del círculo de un punto: el sf::CircleShape tiene su origen en la esquina superior
+    // izquierda, así que el centro está en (x + r, y + r)
+    void tileRange(float minX, float minY, float maxX, float maxY, int &tx0, int &ty0, int &tx1, int &ty1) const {
+        tx0 = clampTile(static_cast<int>(std::floor(minX)) / tileSize_, tilesX_);
+        ty0 = clampTile(static_cast<int>(std::floor(minY)) / tileSize_, tilesY_);
+        tx1 = clampTile(static_cast<int>(std::floor(maxX)) / tileSize_, tilesX_);
+        ty1 = clampTile(static_cast<int>(std::floor(maxY)) / tileSize_, tilesY_);
+    }
+
+    static int clampTile(int t, int count) {
+        return t < 0 ? 0 : (t >= count ? count - 1 : t);
+    }
+
+    bool visible(float minX, float minY, float maxX, float maxY) const {
+        return maxX >= 0 && maxY >= 0 && minX < width_ && minY < height_;
+    }
+
+    // Reparte los índices de las estrellas por mosaico en dos pasadas (contar y llenar).
+    // Las estrellas se parten en un tramo contiguo por hilo y cada tramo cuenta por separado,
+    // así que el orden dentro de cada mosaico es el mismo que el del arreglo y la imagen no
+    // depende de la cantidad de hilos.
+    void binStars(const StarStore &stars) {
+        int numPoints = static_cast<int>(stars.count());
+        int tiles = tileCount();
+        int parts = omp_get_max_threads();
+        counts_.assign(static_cast<std::size_t>(parts) * tiles, 0);
+        auto partBegin = [numPoints, parts](int part) {
+            return static_cast<int>(static_cast<long long>(numPoints) * part / parts);
+        };
+
+        parallelFor(policy_, 0, parts, [&](int part) {
+            int *count = &counts_[static_cast<std::size_t>(part) * tiles];
+            for (int i = partBegin(part), last = partBegin(part + 1); i < last; ++i) {
+                forEachTile(stars, i, [count](int tile) { ++count[tile]; });
+            }
+        });
+
+        // Prefijo en orden (mosaico, tramo)
+        int offset = 0;
+        for (int tile = 0; tile < tiles; ++tile) {
+            tileStart_[tile] = offset;
+            for (int t = 0; t < parts; ++t) {
+                int c = counts_[static_cast<std::size_t>(t) * tiles + tile];
+                counts_[static_cast<std::size_t>(t) * tiles + tile] = offset;
+                offset += c;
+            }
+        }
+        tileStart_[tiles] = offset;
+        binned_.resize(offset);
+
+        parallelFor(policy_, 0, parts, [&](int part) {
+            int *count = &counts_[static_cast<std::size_t>(part) * tiles];
+            for (int i = partBegin(part), last = partBegin(part + 1); i < last; ++i) {
+                forEachTile(stars, i, [this, count, i](int tile) { binned_[count[tile]++] = i; });
+            }
+        });
+    }
+
+    template <typename F>
+    void forEachTile(const StarStore &stars, int i, F f) const {
+        float size = stars.pointSize[i];
+        float minX = stars.x[i], minY = stars.y[i];
+        float maxX = minX + 2 * size, maxY = minY + 2 * size;
+        if (!visible(minX, minY, maxX, maxY)) {
+            return;
+        }
+        int tx0, ty0, tx1, ty1;
+        tileRange(minX, minY, maxX, maxY, tx0, ty0, tx1, ty1);
+        for (int ty = ty0; ty <= ty1; ++ty) {
+            for (int tx = tx0; tx <= tx1; ++tx) {
+                f(ty * tilesX_ + tx);
+            }
+        }
+    }
+
+    // Las estrellas adicionales son pocas: se reparten en serie
+    void binExtraStars(const ExtraStarPool &extraStars) {
+        const StarGeometry &geometry = extraStarGeometry();
+        extraBins_.assign(tileCount(), std::vector<int>());
+        for (std::size_t k = 0; k < extraStars.count(); ++k) {
+            float minX = extraStars.x(k) + geometry.minX, maxX = extraStars.x(k) + geometry.maxX;
+            float minY = extraStars.y(k) + geometry.minY, maxY = extraStars.y(k) + geometry.maxY;
+            if (!visible(minX, minY, maxX, maxY)) {
+                continue;
+            }
+            int tx0, ty0, tx1, ty1;
+            tileRange(minX, minY, maxX, maxY, tx0, ty0, tx1, ty1);
+            for (int ty = ty0; ty <= ty1; ++ty) {
+                for (int tx = tx0; tx <= tx1; ++tx) {
+                    extraBins_[ty * tilesX_ + tx].push_back(static_cast<int>(k));
+                }
+            }
+        }
+    }
+
+    void tileBounds(int tile, int &x0, int &y0, int &x1, int &y1) const {
+        x0 = (tile % tilesX_) * tileSize_;
+        y0 = (tile / tilesX_) * tileSize_;
+        x1 = x0 + tileSize_ < width_ ? x0 + tileSize_ : width_;
+        y1 = y0 + tileSize_ < height_ ? y0 + tileSize_ : height_;
+    }
+
+    void renderTile(int tile, const StarStore &stars, const Palette &palette,
+                    const ExtraStarPool &extraStars, Framebuffer &frame) {
+        int x0, y0, x1, y1;
+        tileBounds(tile, x0, y0, x1, y1);
+
+        // Fondo negro
+        bool byId = stars.id.size() != 0;
+        for (int py = y0; py < y1; ++py) {
+            std::uint8_t *row = &frame.pixels[(static_cast<std::size_t>(py) * width_ + x0) * 3];
+            std::fill(row, row + (x1 - x0) * 3, static_cast<std::uint8_t>(0));
+            if (byId) {
+                std::uint32_t *ids = &drawnId_[static_cast<std::size_t>(py) * width_ + x0];
+                std::fill(ids, ids + (x1 - x0), std::uint32_t(0));
+            }
+        }
+
+        // Puntos de la galaxia: círculos opacos de radio 1 o 2; cuenta un píxel si su
+        // centro cae dentro del círculo. Si las estrellas están reordenadas (--spatial-order)
+        // queda encima la de mayor id, como en el arreglo sin ordenar.
+        for (int b = tileStart_[tile]; b < tileStart_[tile + 1]; ++b) {
+            int i = binned_[b];
+            float r = stars.pointSize[i];
+            float cx = stars.x[i] + r;
+            float cy = stars.y[i] + r;
+            const PaletteColor &color = palette.colorOf(stars, i);
+            std::uint32_t key = stars.idOf(i) + 1;
+            forEachCirclePixel(cx, cy, r, x0, y0, x1, y1, [&](int px, int py) {
+                std::size_t pixel = static_cast<std::size_t>(py) * width_ + px;
+                if (byId) {
+                    if (drawnId_[pixel] > key) {
+                        return;
+                    }
+                    drawnId_[pixel] = key;
+                }
+                std::uint8_t *p = &frame.pixels[pixel * 3];
+                p[0] = color.r;
+                p[1] = color.g;
+                p[2] = color.b;
+            });
+        }
+
+        // Estrellas adicionales
+        for (int k : extraBins_[tile]) {
+            blendExtraStar(extraStars, k, x0, y0, x1, y1, frame);
+        }
+    }
+
+    int width_, height_, tileSize_;
+    int tilesX_, tilesY_;
+    ParallelPolicy policy_{ParallelBackend::OmpDynamic, 0};
+    std::vector<int> counts_;     // Conteo (y luego posición de escritura) por tramo y mosaico
+    std::vector<int> tileStart_;  // Inicio de cada mosaico dentro de binned_
+    std::vector<int> binned_;     // Índices de estrellas agrupados por mosaico
+    std::vector<std::uint32_t> drawnId_; // id + 1 de la estrella dibujada en cada píxel (solo con ids)
+    std::vector<std::vector<int>> extraBins_;
+};
+
+// Pasa a colores la cobertura ya reducida de todas las partes y encima mezcla las estrellas
+// adicionales, en el mismo orden que el rasterizador por mosaicos
+inline void resolveCoverage(const std::vector<std::uint64_t> &coverage, const Palette &palette,
+                            const ExtraStarPool &extraStars, Framebuffer &frame) {
+    std::size_t pixels = static_cast<std::size_t>(frame.width) * frame.height;
+#pragma omp parallel for schedule(static)
+    for (std::size_t p = 0; p < pixels; ++p) {
+        std::uint8_t *rgb = &frame.pixels[p * 3];
+        if (coverage[p] == 0) {
+            rgb[0] = rgb[1] = rgb[2] = 0;
+        } else {
+            const PaletteColor &color = palette[static_cast<std::uint16_t>(coverage[p] & 0xFFFF)];
+            rgb[0] = color.r;
+            rgb[1] = color.g;
+            rgb[2] = color.b;
+        }
+    }
+    for (std::size_t k = 0; k < extraStars.count(); ++k) {
+        blendExtraStar(extraStars, k, 0, 0, frame.width, frame.height, frame);
+    }
+}
+
+// Escribe los frames como una secuencia de imágenes PPM o como un flujo RGB24 sin
+// encabezado, por ejemplo para pasarlo a un codificador:
+//   ... --raw - | ffmpeg -f rawvideo -pix_fmt rgb24 -s 800x800 -r 60 -i - galaxia.mp4
+class FrameWriter {
+public:
+    // pattern es un formato de printf con el número de frame, p. ej. "frames/galaxia_%05d.ppm".
+    // Como llega de la línea de comandos, solo se acepta una conversión %d (con ancho y relleno
+    // de ceros opcionales) y %% para un '%' literal: cualquier otra iría a snprintf sin argumento.
+    bool openSequence(const std::string &pattern) {
+        int conversions = 0;
+        for (std::size_t k = 0; k < pattern.size(); ++k) {
+            if (pattern[k] != '%') {
+                continue;
+            }
+            if (k + 1 < pattern.size() && pattern[k + 1] == '%') {
+                ++k;
+                continue;
+            }
+            std::size_t end = k + 1;
+            while (end < pattern.size() && std::isdigit(static_cast<unsigned char>(pattern[end]))) {
+                ++end;
+            }
+            if (end >= pattern.size() || pattern[end] != 'd' || end - k > 4) {
+                conversions = -1;
+                break;
+            }
+            ++conversions;
+            k = end;
+        }
+        if (conversions != 1) {
+            std::cerr << "Patron de salida invalido: " << pattern
+                      << " (debe tener exactamente un %d o %0Nd; use %% para un '%')\n";
+            return false;
+        }
+        pattern_ = pattern;
+        return true;
+    }
+
+    // "-" escribe en la salida estándar
+    bool openRaw(const std::string &path) {
+        if (path == "-") {
+#ifdef _WIN32
+            _setmode(_fileno(stdout), _O_BINARY);
+#endif
+            raw_ = stdout;
+            return true;
+        }
+        raw_ = std::fopen(path.c_str(), "wb");
+        ownsRaw_ = raw_ != nullptr;
+        return raw_ != nullptr;
+    }
+
+    ~FrameWriter() {
+        if (ownsRaw_) {
+            std::fclose(raw_);
+        } else if (raw_) {
+            std::fflush(raw_);
+        }
+    }
+
+    bool write(const Framebuffer &frame) {
+        std::size_t bytes = frame.pixels.size();
+        bool ok = true;
+        if (!pattern_.empty()) {
+            char path[1024];
+            int length = std::snprintf(path, sizeof(path), pattern_.c_str(), index_);
+            if (length < 0 || length >= static_cast<int>(sizeof(path))) {
+                return false;
+            }
+            std::FILE *file = std::fopen(path, "wb");
+            if (!file) {
+                return false;
+            }
+            std::fprintf(file, "P6\n%d %d\n255\n", frame.width, frame.height);
+            ok = std::fwrite(frame.pixels.data(), 1, bytes, file) == bytes;
+            std::fclose(file);
+        }
+        if (raw_) {
+            ok = ok && std::fwrite(frame.pixels.data(), 1, bytes, raw_) == bytes;
+        }
+        ++index_;
+        return ok;
+    }
+
+    bool writesToStdout() const {
+        return raw_ == stdout;
+    }
+
+private:
+    std::string pattern_;
+    std::FILE *raw_ = nullptr;
+    bool ownsRaw_ = false;
+    int index_ = 0;
+};
+
+#endif //PARALLEL_SCREENSAVER_SOFTWARE_RASTER_H
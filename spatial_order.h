@@ -0,0 +1,204 @@
+/*
+* Nombre: spatial_order.h
+* Autores:
+  - Andrés Montoya, 21552
+  - Fernanda Esquivel, 21542
+  - Francisco Castillo, 21562
+* Descripción: Orden espacial de las estrellas: cada cierto número de pasos se reordenan los arreglos
+  según la celda de la pantalla en que cae cada estrella (curva de Morton), para que estrellas
+  vecinas en memoria también lo sean en el frame.
+* Lenguaje: C++
+* Recursos: CLion, OpenMP
+* Historial:
+  - Creado el 17.10.2026
+*/
+
+#ifndef PARALLEL_SCREENSAVER_SPATIAL_ORDER_H
+#define PARALLEL_SCREENSAVER_SPATIAL_ORDER_H
+
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include <omp.h>
+
+#include "galaxy.h"
+#include "parallel_backend.h"
+#include "star_store.h"
+
+// Lado en píxeles de las celdas de la curva de Morton
+const int kOrderCell = 8;
+
+// Intercala los bits de x e y (16 bits cada uno): celdas cercanas tienen códigos cercanos
+inline std::uint32_t mortonCode(std::uint32_t x, std::uint32_t y) {
+    auto spread = [](std::uint32_t v) {
+        v &= 0xFFFF;
+        v = (v | (v << 8)) & 0x00FF00FF;
+        v = (v | (v << 4)) & 0x0F0F0F0F;
+        v = (v | (v << 2)) & 0x33333333;
+        v = (v | (v << 1)) & 0x55555555;
+        return v;
+    };
+    return spread(x) | (spread(y) << 1);
+}
+
+namespace spatial_order_detail {
+
+// column[i] = column[source[i]] para toda i, pasando por scratch. Al final scratch se queda
+// con la memoria vieja de la columna y sirve para la siguiente del mismo tipo.
+template <typename T>
+void gatherColumn(StarColumn<T> &column, StarColumn<T> &scratch, const std::vector<int> &source,
+                  const ParallelPolicy &policy) {
+    int numPoints = static_cast<int>(source.size());
+    int numBlocks = (numPoints + kUpdateBlock - 1) / kUpdateBlock;
+    scratch.resize(source.size());
+    parallelFor(policy, 0, numBlocks, [&](int block) {
+        int begin = block * kUpdateBlock;
+        int end = std::min(begin + kUpdateBlock, numPoints);
+        for (int i = begin; i < end; ++i) {
+            scratch[i] = column[source[i]];
+        }
+    });
+    column.swap(scratch);
+}
+
+} // namespace spatial_order_detail
+
+// Reordena las estrellas por celdas de la pantalla. Es un ordenamiento por conteo estable
+// en O(n): entre dos reordenamientos las estrellas solo se mueven unos píxeles, así que casi
+// todas siguen en su celda o en una vecina y las escrituras son casi secuenciales. Cada
+// estrella lleva su índice original en stars.id, del que dependen sus sorteos.
+class SpatialOrder {
+public:
+    // period: pasos entre reordenamientos
+    SpatialOrder(int width, int height, int period, const ParallelPolicy &policy = ParallelPolicy())
+        : cellsX_((width + kOrderCell - 1) / kOrderCell), cellsY_((height + kOrderCell - 1) / kOrderCell),
+          period_(std::max(1, period)), policy_(policy) {
+        // Posición de cada celda dentro de la curva, numerando solo las celdas que existen
+        std::vector<std::pair<std::uint32_t, int>> codes;
+        codes.reserve(static_cast<std::size_t>(cellsX_) * cellsY_);
+        for (int cy = 0; cy < cellsY_; ++cy) {
+            for (int cx = 0; cx < cellsX_; ++cx) {
+                codes.emplace_back(mortonCode(cx, cy), cy * cellsX_ + cx);
+            }
+        }
+        std::sort(codes.begin(), codes.end());
+        cellRank_.resize(codes.size());
+        for (std::size_t k = 0; k < codes.size(); ++k) {
+            cellRank_[codes[k].second] = static_cast<int>(k);
+        }
+    }
+
+    int period() const {
+        return period_;
+    }
+
+    // Llamar una vez por paso; reordena cada period pasos
+    bool maybeReorder(StarStore &stars) {
+        if (++steps_ < period_) {
+            return false;
+        }
+        steps_ = 0;
+        reorder(stars);
+        return true;
+    }
+
+    void reorder(StarStore &stars) {
+        int numPoints = static_cast<int>(stars.count());
+        if (stars.id.size() != stars.count()) {
+            stars.id.resize(stars.count());
+            parallelFor(policy_, 0, numPoints, [&](int i) { stars.id[i] = static_cast<std::uint32_t>(i); });
+        }
+
+        // Conteo por tramo contiguo y celda, como el reparto en mosaicos del rasterizador
+        int buckets = static_cast<int>(cellRank_.size());
+        int parts = omp_get_max_threads();
+        keys_.resize(numPoints);
+        order_.resize(numPoints);
+        counts_.assign(static_cast<std::size_t>(parts) * buckets, 0);
+        auto partBegin = [numPoints, parts](int part) {
+            return static_cast<int>(static_cast<long long>(numPoints) * part / parts);
+        };
+
+        parallelFor(policy_, 0, parts, [&](int part) {
+            int *count = &counts_[static_cast<std::size_t>(part) * buckets];
+            for (int i = partBegin(part), last = partBegin(part + 1); i < last; ++i) {
+                int key = cellKey(stars.x[i], stars.y[i]);
+                keys_[i] = key;
+                ++count[key];
+            }
+        });
+
+        int offset = 0;
+        for (int key = 0; key < buckets; ++key) {
+            for (int part = 0; part < parts; ++part) {
+                int &c = counts_[static_cast<std::size_t>(part) * buckets + key];
+                int n = c;
+                c = offset;
+                offset += n;
+            }
+        }
+
+        parallelFor(policy_, 0, parts, [&](int part) {
+            int *count = &counts_[static_cast<std::size_t>(part) * buckets];
+            for (int i = partBegin(part), last = partBegin(part + 1); i < last; ++i) {
+                order_[count[keys_[i]]++] = i;
+            }
+        });
+
+        permute(stars, order_);
+    }
+
+    // Vuelve al orden en que se generaron las estrellas (y vacía stars.id), p. ej. antes de
+    // cambiar cuántas hay o de guardar un snapshot
+    void restore(StarStore &stars) {
+        if (stars.id.size() == 0) {
+            return;
+        }
+        int numPoints = static_cast<int>(stars.count());
+        order_.resize(numPoints);
+        parallelFor(policy_, 0, numPoints, [&](int i) { order_[stars.id[i]] = i; });
+        permute(stars, order_);
+        StarColumn<std::uint32_t>().swap(stars.id);
+    }
+
+private:
+    int cellKey(float x, float y) const {
+        int cx = std::min(std::max(static_cast<int>(x) / kOrderCell, 0), cellsX_ - 1);
+        int cy = std::min(std::max(static_cast<int>(y) / kOrderCell, 0), cellsY_ - 1);
+        return cellRank_[cy * cellsX_ + cx];
+    }
+
+    void permute(StarStore &stars, const std::vector<int> &source) {
+        using spatial_order_detail::gatherColumn;
+        gatherColumn(stars.radius, floatScratch_, source, policy_);
+        gatherColumn(stars.angle, floatScratch_, source, policy_);
+        gatherColumn(stars.pointSize, floatScratch_, source, policy_);
+        gatherColumn(stars.x, floatScratch_, source, policy_);
+        gatherColumn(stars.y, floatScratch_, source, policy_);
+        gatherColumn(stars.palette, indexScratch_, source, policy_);
+        gatherColumn(stars.generation, wordScratch_, source, policy_);
+        gatherColumn(stars.id, wordScratch_, source, policy_);
+    }
+
+    int cellsX_, cellsY_;
+    int period_;
+    int steps_ = 0;
+    ParallelPolicy policy_;
+    std::vector<int> cellRank_;   // Posición en la curva de cada celda (fila por fila)
+    std::vector<int> keys_;       // Celda de cada estrella
+    std::vector<int> counts_;     // Conteo (y luego posición de escritura) por tramo y celda
+    std::vector<int> order_;      // Índice viejo de la estrella que va en cada posición
+    StarColumn<float> floatScratch_;
+    StarColumn<std::uint16_t> indexScratch_;
+    StarColumn<std::uint32_t> wordScratch_;
+};
+
+// Vuelve al orden de generación sin un SpatialOrder a mano
+inline void restoreGenerationOrder(StarStore &stars, const ParallelPolicy &policy = ParallelPolicy()) {
+    if (stars.id.size() != 0) {
+        SpatialOrder(kOrderCell, kOrderCell, 1, policy).restore(stars);
+    }
+}
+
+#endif //PARALLEL_SCREENSAVER_SPATIAL_ORDER_H
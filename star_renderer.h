@@ -0,0 +1,100 @@
+/*
+* Nombre: star_renderer.h
+* Autores:
+  - Andrés Montoya, 21552
+  - Fernanda Esquivel, 21542
+  - Francisco Castillo, 21562
+* Descripción: Dibujo de todas las estrellas de la galaxia en un solo lote de vértices (SFML + OpenMP).
+* Lenguaje: C++
+* Recursos: CLion, SFML
+* Historial:
+  - Creado el 17.10.2026
+  - Modificado el 17.10.2026 (subir imágenes hechas en CPU a una textura)
+*/
+
+#ifndef PARALLEL_SCREENSAVER_STAR_RENDERER_H
+#define PARALLEL_SCREENSAVER_STAR_RENDERER_H
+
+#include <SFML/Graphics.hpp>
+#include <cstddef>
+#include <vector>
+
+#include "extra_stars.h"
+#include "palette.h"
+#include "software_raster.h"
+#include "star_store.h"
+
+// Llena un arreglo de vértices con un cuadrado por estrella. Cada cuadrado cubre la misma
+// caja que el sf::CircleShape de 1 o 2 píxeles que se dibujaba antes (origen en la esquina
+// superior izquierda), así que la galaxia se dibuja con una sola llamada a draw.
+inline void buildStarVertices(const StarStore &stars, const Palette &palette, sf::VertexArray &vertices) {
+    int numPoints = static_cast<int>(stars.count());
+    vertices.setPrimitiveType(sf::Quads);
+    if (vertices.getVertexCount() != stars.count() * 4) {
+        vertices.resize(stars.count() * 4);
+    }
+
+#pragma omp parallel for
+    for (int i = 0; i < numPoints; ++i) {
+        float x = stars.x[i];
+        float y = stars.y[i];
+        float side = 2.0f * stars.pointSize[i];
+        const PaletteColor &entry = palette.colorOf(stars, i);
+        sf::Color color(entry.r, entry.g, entry.b, entry.a);
+
+        sf::Vertex *quad = &vertices[i * 4];
+        quad[0].position = sf::Vector2f(x, y);
+        quad[1].position = sf::Vector2f(x + side, y);
+        quad[2].position = sf::Vector2f(x + side, y + side);
+        quad[3].position = sf::Vector2f(x, y + side);
+        quad[0].color = color;
+        quad[1].color = color;
+        quad[2].color = color;
+        quad[3].color = color;
+    }
+}
+
+// Llena un arreglo de triángulos con todas las estrellas adicionales: cada una es un abanico
+// de 10 triángulos sobre la geometría compartida, con la opacidad según su tiempo de vida.
+inline void buildExtraStarVertices(const ExtraStarPool &pool, sf::VertexArray &vertices) {
+    const StarGeometry &geometry = extraStarGeometry();
+    const int verticesPerStar = StarGeometry::kVertices * 3;
+    int count = static_cast<int>(pool.count());
+    vertices.setPrimitiveType(sf::Triangles);
+    vertices.resize(pool.count() * verticesPerStar);
+
+#pragma omp parallel for
+    for (int k = 0; k < count; ++k) {
+        float x = pool.x(k);
+        float y = pool.y(k);
+        sf::Color color(255, 255, 255, pool.alpha(k));
+        sf::Vertex *triangle = &vertices[k * verticesPerStar];
+        for (int v = 0; v < StarGeometry::kVertices; ++v) {
+            int next = (v + 1) % StarGeometry::kVertices;
+            triangle[0].position = sf::Vector2f(x + geometry.centerX, y + geometry.centerY);
+            triangle[1].position = sf::Vector2f(x + geometry.x[v], y + geometry.y[v]);
+            triangle[2].position = sf::Vector2f(x + geometry.x[next], y + geometry.y[next]);
+            triangle[0].color = color;
+            triangle[1].color = color;
+            triangle[2].color = color;
+            triangle += 3;
+        }
+    }
+}
+
+// Copia una imagen RGB hecha en CPU a una textura (SFML solo acepta RGBA)
+inline void uploadFramebuffer(const Framebuffer &frame, sf::Texture &texture, std::vector<sf::Uint8> &rgba) {
+    long long numPixels = static_cast<long long>(frame.width) * frame.height;
+    rgba.resize(static_cast<std::size_t>(numPixels) * 4);
+
+#pragma omp parallel for
+    for (long long p = 0; p < numPixels; ++p) {
+        rgba[p * 4 + 0] = frame.pixels[p * 3 + 0];
+        rgba[p * 4 + 1] = frame.pixels[p * 3 + 1];
+        rgba[p * 4 + 2] = frame.pixels[p * 3 + 2];
+        rgba[p * 4 + 3] = 255;
+    }
+    texture.update(rgba.data());
+}
+
+#endif //PARALLEL_SCREENSAVER_STAR_RENDERER_H
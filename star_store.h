@@ -0,0 +1,234 @@
+/*
+* Nombre: star_store.h
+* Autores:
+  - Andrés Montoya, 21552
+  - Fernanda Esquivel, 21542
+  - Francisco Castillo, 21562
+* Descripción: Almacenamiento de las estrellas como estructura de arreglos (SoA) en coordenadas polares.
+* Lenguaje: C++
+* Recursos: CLion
+* Historial:
+  - Creado el 17.10.2026
+  - Modificado el 17.10.2026 (arreglos sin inicializar para ubicar la memoria por primer acceso)
+  - Modificado el 17.10.2026 (columnas que pueden ver un snapshot mapeado en memoria)
+  - Modificado el 17.10.2026 (índice original de cada estrella, para reordenarlas en el espacio)
+  - Modificado el 17.10.2026 (bytes de estado por estrella)
+*/
+
+#ifndef PARALLEL_SCREENSAVER_STAR_STORE_H
+#define PARALLEL_SCREENSAVER_STAR_STORE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+// Cantidad de niveles del índice de paleta y valor máximo del parámetro del degradado
+const int kPaletteLevels = 1024;
+const float kPaletteRange = 1.1f;
+
+// Asignador que no inicializa los elementos al redimensionar. Así la memoria de cada estrella
+// la toca primero el hilo que la genera en initGalaxy (con el mismo reparto que la
+// actualización) y, en máquinas NUMA, las páginas quedan en el nodo de ese hilo.
+template <typename T>
+struct DefaultInitAllocator : std::allocator<T> {
+    template <typename U>
+    struct rebind {
+        using other = DefaultInitAllocator<U>;
+    };
+
+    DefaultInitAllocator() = default;
+
+    template <typename U>
+    DefaultInitAllocator(const DefaultInitAllocator<U> &) noexcept {}
+
+    template <typename U>
+    void construct(U *p) noexcept {
+        ::new (static_cast<void *>(p)) U;
+    }
+
+    template <typename U, typename... Args>
+    void construct(U *p, Args &&... args) {
+        ::new (static_cast<void *>(p)) U(std::forward<Args>(args)...);
+    }
+};
+
+template <typename T>
+using StarArray = std::vector<T, DefaultInitAllocator<T>>;
+
+// Memoria que no es del proceso (p. ej. un archivo mapeado); se libera con el último que la ve
+struct MappedRegion {
+    virtual ~MappedRegion() {}
+};
+
+// Arreglo de un atributo de las estrellas. Normalmente es dueño de su memoria, pero también
+// puede ver directamente un snapshot mapeado (ver snapshot.h) sin copiarlo; al cambiar de
+// tamaño o al copiarse pasa a tener su propia memoria.
+template <typename T>
+class StarColumn {
+public:
+    typedef T value_type;
+
+    StarColumn() = default;
+
+    StarColumn(const StarColumn &other)
+        : storage_(other.begin(), other.end()), data_(storage_.data()), size_(storage_.size()) {}
+
+    StarColumn(StarColumn &&other) noexcept
+        : storage_(std::move(other.storage_)), data_(other.data_), size_(other.size_),
+          region_(std::move(other.region_)) {
+        other.data_ = nullptr;
+        other.size_ = 0;
+    }
+
+    StarColumn &operator=(const StarColumn &other) {
+        if (this != &other) {
+            storage_.assign(other.begin(), other.end()); // Reutiliza la memoria si ya alcanza
+            region_.reset();
+            data_ = storage_.data();
+            size_ = storage_.size();
+        }
+        return *this;
+    }
+
+    StarColumn &operator=(StarColumn &&other) noexcept {
+        storage_ = std::move(other.storage_);
+        region_ = std::move(other.region_);
+        data_ = other.data_;
+        size_ = other.size_;
+        other.data_ = nullptr;
+        other.size_ = 0;
+        return *this;
+    }
+
+    // Los valores nuevos quedan sin inicializar
+    void resize(std::size_t count) {
+        if (region_) {
+            storage_.assign(begin(), begin() + (count < size_ ? count : size_));
+            region_.reset();
+        }
+        storage_.resize(count);
+        data_ = storage_.data();
+        size_ = count;
+    }
+
+    // Usa memoria externa en lugar de la propia
+    void view(T *data, std::size_t count, const std::shared_ptr<MappedRegion> &region) {
+        StarArray<T>().swap(storage_);
+        data_ = data;
+        size_ = count;
+        region_ = region;
+    }
+
+    bool mapped() const {
+        return region_ != nullptr;
+    }
+
+    void swap(StarColumn &other) noexcept {
+        storage_.swap(other.storage_);
+        std::swap(data_, other.data_);
+        std::swap(size_, other.size_);
+        region_.swap(other.region_);
+    }
+
+    T &operator[](std::size_t i) {
+        return data_[i];
+    }
+
+    const T &operator[](std::size_t i) const {
+        return data_[i];
+    }
+
+    T *data() {
+        return data_;
+    }
+
+    const T *data() const {
+        return data_;
+    }
+
+    std::size_t size() const {
+        return size_;
+    }
+
+    T *begin() {
+        return data_;
+    }
+
+    T *end() {
+        return data_ + size_;
+    }
+
+    const T *begin() const {
+        return data_;
+    }
+
+    const T *end() const {
+        return data_ + size_;
+    }
+
+private:
+    StarArray<T> storage_;
+    T *data_ = nullptr;
+    std::size_t size_ = 0;
+    std::shared_ptr<MappedRegion> region_;
+};
+
+// Estado de la simulación: un arreglo contiguo por atributo en lugar de un sf::CircleShape por estrella.
+// El ángulo y el radio son el estado; x e y se recalculan en cada frame para dibujar.
+struct StarStore {
+    StarColumn<float> radius;              // Distancia al centro
+    StarColumn<float> angle;               // Ángulo en radianes, acotado a [0, 2π)
+    StarColumn<float> pointSize;           // Radio del círculo en píxeles (1 o 2)
+    StarColumn<std::uint16_t> palette;     // Índice de color dentro del degradado
+    StarColumn<std::uint32_t> generation;  // Veces que la estrella ha reaparecido en el borde
+
+    StarColumn<float> x;                   // Posición cartesiana calculada por la actualización
+    StarColumn<float> y;
+
+    // Índice con que se generó cada estrella. Vacío mientras siguen en ese orden; lo llena
+    // spatial_order.h al reordenarlas. Los sorteos dependen de este índice, no de la posición.
+    StarColumn<std::uint32_t> id;
+
+    // Los valores nuevos quedan sin inicializar: initGalaxy los escribe todos
+    void resize(std::size_t count) {
+        radius.resize(count);
+        angle.resize(count);
+        pointSize.resize(count);
+        palette.resize(count);
+        generation.resize(count);
+        x.resize(count);
+        y.resize(count);
+    }
+
+    std::size_t count() const {
+        return radius.size();
+    }
+
+    std::uint32_t idOf(std::size_t i) const {
+        return id.size() ? id[i] : static_cast<std::uint32_t>(i);
+    }
+
+    // Bytes de estado por estrella (sin id, que solo existe con --spatial-order)
+    static std::size_t bytesPerStar() {
+        return sizeof(decltype(radius)::value_type) + sizeof(decltype(angle)::value_type) +
+               sizeof(decltype(pointSize)::value_type) + sizeof(decltype(palette)::value_type) +
+               sizeof(decltype(generation)::value_type) + sizeof(decltype(x)::value_type) +
+               sizeof(decltype(y)::value_type);
+    }
+};
+
+// Convierte el parámetro del degradado (radio normalizado) en un índice de paleta
+inline std::uint16_t paletteIndex(float t) {
+    if (t < 0.0f) t = 0.0f;
+    if (t > kPaletteRange) t = kPaletteRange;
+    return static_cast<std::uint16_t>(t / kPaletteRange * (kPaletteLevels - 1) + 0.5f);
+}
+
+// Operación inversa: parámetro del degradado correspondiente a un índice
+inline float paletteParameter(std::uint16_t index) {
+    return static_cast<float>(index) * kPaletteRange / (kPaletteLevels - 1);
+}
+
+#endif //PARALLEL_SCREENSAVER_STAR_STORE_H
@@ -0,0 +1,101 @@
+/*
+* Nombre: star_update.h
+* Autores:
+  - Andrés Montoya, 21552
+  - Fernanda Esquivel, 21542
+  - Francisco Castillo, 21562
+* Descripción: Paso de actualización escalar de las estrellas (rotación, atracción y reaparición).
+* Lenguaje: C++
+* Recursos: CLion
+* Historial:
+  - Creado el 17.10.2026
+  - Modificado el 17.10.2026 (sorteos de la reaparición separados para el estado compacto)
+  - Modificado el 17.10.2026 (índice global de la primera estrella, para repartir la galaxia entre procesos)
+  - Modificado el 17.10.2026 (sorteos por el índice original de la estrella, que no cambia al reordenar)
+*/
+
+#ifndef PARALLEL_SCREENSAVER_STAR_UPDATE_H
+#define PARALLEL_SCREENSAVER_STAR_UPDATE_H
+
+#include <cmath>
+#include <cstdint>
+
+#include "counter_rng.h"
+#include "palette.h"
+#include "star_store.h"
+
+const float kTwoPi = 2 * 3.14159f;
+
+// Parámetros que necesita la simulación en cada frame
+struct GalaxyParams {
+    float centerX = 400.0f;            // Centro de la galaxia en la ventana
+    float centerY = 400.0f;
+    float maxRadius = 450.0f;          // Radio máximo de la galaxia
+    float speed = 0.035f;              // Velocidad de los puntos moviéndose hacia el centro
+    float baseRotationSpeed = 0.0007f; // Velocidad base de la rotación de la galaxia
+    std::uint64_t seed = 0;            // Semilla de los números aleatorios
+    std::uint32_t firstStar = 0;       // Índice global de la estrella 0 del arreglo (parte de otro proceso)
+};
+
+// Ángulo y radio con que reaparece la estrella i por vez número generation, a partir del ángulo
+// en que llegó al centro. Los sorteos dependen de la estrella y de cuántas veces ha reaparecido,
+// no del orden en que los hilos llegan aquí. Se usa el índice global, así que una parte de la
+// galaxia en otro proceso sortea lo mismo que la galaxia completa.
+inline void respawnDraw(const GalaxyParams &params, int i, std::uint32_t generation, float &angle, float &radius) {
+    std::uint32_t star = params.firstStar + static_cast<std::uint32_t>(i);
+
+    // Añadir alguna variación aleatoria al ángulo y radio
+    radius = params.maxRadius;
+    angle += randomUniform(params.seed, kStreamRespawn, star, generation, 0) * 0.2f - 0.1f;
+    radius *= 0.9f + randomUniform(params.seed, kStreamRespawn, star, generation, 1) * 0.2f;
+
+    if (angle >= kTwoPi) angle -= kTwoPi;
+    if (angle < 0.0f) angle += kTwoPi;
+}
+
+// Mueve la estrella i al borde de la galaxia. Se llama después de avanzar su ángulo,
+// cuando el radio quedó por debajo de cero; también recalcula su posición.
+inline void respawnStar(StarStore &stars, const GalaxyParams &params, int i) {
+    float angle = stars.angle[i];
+    float radius;
+    respawnDraw(params, static_cast<int>(stars.idOf(i)), ++stars.generation[i], angle, radius);
+
+    // Establecer un nuevo color para el punto basado en la distancia
+    stars.palette[i] = respawnPaletteIndex(radius / params.maxRadius);
+
+    stars.angle[i] = angle;
+    stars.radius[i] = radius;
+    stars.x[i] = params.centerX + radius * std::cos(angle);
+    stars.y[i] = params.centerY + radius * std::sin(angle);
+}
+
+// Actualiza las estrellas [begin, end) sin instrucciones vectoriales
+inline void updateStarsScalar(StarStore &stars, const GalaxyParams &params, int begin, int end) {
+    const float maxRadius = params.maxRadius;
+
+    for (int i = begin; i < end; ++i) {
+        float angle = stars.angle[i];
+        float radius = stars.radius[i];
+
+        float rotationSpeed = params.baseRotationSpeed * (1.0f + (maxRadius - radius) / maxRadius);
+        angle += rotationSpeed;
+
+        float attractionSpeed = params.speed * (1.0f + (maxRadius - radius) / maxRadius);
+        radius -= attractionSpeed;
+
+        // Mantener el ángulo acotado para no perder precisión con el tiempo
+        if (angle >= kTwoPi) angle -= kTwoPi;
+
+        stars.angle[i] = angle;
+        if (radius < 0) {
+            respawnStar(stars, params, i);
+            continue;
+        }
+
+        stars.radius[i] = radius;
+        stars.x[i] = params.centerX + radius * std::cos(angle);
+        stars.y[i] = params.centerY + radius * std::sin(angle);
+    }
+}
+
+#endif //PARALLEL_SCREENSAVER_STAR_UPDATE_H
@@ -0,0 +1,181 @@
+/*
+* Nombre: time_step.h
+* Autores:
+  - Andrés Montoya, 21552
+  - Fernanda Esquivel, 21542
+  - Francisco Castillo, 21562
+* Descripción: Avance de la galaxia por tiempo en forma cerrada, independiente de los FPS y con saltos directos.
+* Lenguaje: C++
+* Recursos: CLion
+* Historial:
+  - Creado el 17.10.2026
+  - Modificado el 17.10.2026 (política paralela intercambiable)
+  - Modificado el 17.10.2026 (cambiar la cantidad de estrellas durante la simulación)
+  - Modificado el 17.10.2026 (avance con otro kernel de un paso, para la rotación por bandas)
+  - Modificado el 17.10.2026 (cambiar la cantidad de estrellas en el orden de generación)
+*/
+
+#ifndef PARALLEL_SCREENSAVER_TIME_STEP_H
+#define PARALLEL_SCREENSAVER_TIME_STEP_H
+
+#include <cmath>
+#include <cstdint>
+
+#include "galaxy.h"
+#include "simd_update.h"
+#include "spatial_order.h"
+#include "star_store.h"
+#include "star_update.h"
+
+// Las velocidades de la galaxia están expresadas por frame; un tick es uno de esos pasos
+// y el programa original dibujaba unos 60 por segundo
+const double kTicksPerSecond = 60.0;
+
+// Con u = 2 - r/R y q = 1 + s/R, un paso del ciclo original es
+//     u' = q·u        θ' = θ + b·u
+// así que después de τ ticks (τ no tiene que ser entero)
+//     u(τ) = u·q^τ    θ(τ) = θ + b·u·(q^τ - 1)/(q - 1)
+// La estrella reaparece cuando u llega a 2 (radio cero), en τ* = ln(2/u)/ln(q).
+struct TimeStep {
+    double ticks = 0.0;
+    double logGrowth = 0.0;  // ln(q)
+    double growth = 1.0;     // q^τ
+    double gain = 0.0;       // (q^τ - 1)/(q - 1): ticks "efectivos" para el ángulo y el radio
+};
+
+inline TimeStep makeTimeStep(const GalaxyParams &params, double ticks) {
+    TimeStep step;
+    double rate = static_cast<double>(params.speed) / params.maxRadius;  // q - 1
+    step.ticks = ticks;
+    step.logGrowth = std::log1p(rate);
+    step.growth = std::exp(ticks * step.logGrowth);
+    step.gain = std::expm1(ticks * step.logGrowth) / rate;
+    return step;
+}
+
+// Avanza una estrella τ ticks a partir de su estado (radio, ángulo) con la fórmula cerrada,
+// reapareciendo en el borde cuantas veces haga falta. Cada reaparición incrementa la
+// generación, así que los sorteos son los mismos que daría avanzar de a un tick.
+inline void advanceStarExact(StarStore &stars, const GalaxyParams &params, const TimeStep &step, int i,
+                             float radius, float angle) {
+    const double maxRadius = params.maxRadius;
+    const double rate = static_cast<double>(params.speed) / maxRadius;
+    double u = 2.0 - radius / maxRadius;
+    double theta = angle;
+    double remaining = step.ticks;
+
+    for (;;) {
+        double hit = u < 2.0 ? std::log(2.0 / u) / step.logGrowth : 0.0;
+        if (hit > remaining) {
+            break;
+        }
+        // Llegar al centro y reaparecer
+        theta += params.baseRotationSpeed * (2.0 - u) / rate;
+        remaining -= hit;
+        stars.angle[i] = static_cast<float>(std::fmod(theta, static_cast<double>(kTwoPi)));
+        respawnStar(stars, params, i);
+        u = 2.0 - stars.radius[i] / maxRadius;
+        theta = stars.angle[i];
+    }
+
+    double growth = std::exp(remaining * step.logGrowth);
+    theta += params.baseRotationSpeed * u * std::expm1(remaining * step.logGrowth) / rate;
+    u *= growth;
+
+    float newAngle = static_cast<float>(std::fmod(theta, static_cast<double>(kTwoPi)));
+    float newRadius = static_cast<float>(maxRadius * (2.0 - u));
+    stars.angle[i] = newAngle;
+    stars.radius[i] = newRadius;
+    stars.x[i] = params.centerX + newRadius * std::cos(newAngle);
+    stars.y[i] = params.centerY + newRadius * std::sin(newAngle);
+}
+
+// Sin reapariciones, τ ticks equivalen a un solo paso del kernel original con las velocidades
+// multiplicadas por (q^τ - 1)/(q - 1)
+inline GalaxyParams scaledParams(const GalaxyParams &params, const TimeStep &step) {
+    GalaxyParams scaled = params;
+    scaled.speed = static_cast<float>(params.speed * step.gain);
+    scaled.baseRotationSpeed = static_cast<float>(params.baseRotationSpeed * step.gain);
+    return scaled;
+}
+
+// Avanza la galaxia τ ticks de una vez con un kernel de un paso (que recibe las velocidades
+// escaladas); solo las estrellas que reaparecieron se recalculan una por una desde su estado
+// anterior con la fórmula exacta.
+template <typename Kernel>
+void advanceGalaxyWith(StarStore &stars, const GalaxyParams &params, double ticks, const ParallelPolicy &policy,
+                       Kernel kernel) {
+    if (ticks <= 0.0) {
+        return;
+    }
+    TimeStep step = makeTimeStep(params, ticks);
+    GalaxyParams scaled = scaledParams(params, step);
+
+    // Después de una reaparición u está entre 0.9 y 1.1; si q^τ >= 4 todas las estrellas
+    // reaparecen y el kernel solo haría trabajo de más
+    bool allRespawn = step.growth >= 4.0;
+    int numPoints = static_cast<int>(stars.count());
+    int numBlocks = (numPoints + kUpdateBlock - 1) / kUpdateBlock;
+
+    parallelFor(policy, 0, numBlocks, [&](int block) {
+        int begin = block * kUpdateBlock;
+        int end = begin + kUpdateBlock < numPoints ? begin + kUpdateBlock : numPoints;
+        float savedRadius[kUpdateBlock];
+        float savedAngle[kUpdateBlock];
+        std::uint32_t savedGeneration[kUpdateBlock];
+        for (int i = begin; i < end; ++i) {
+            savedRadius[i - begin] = stars.radius[i];
+            savedAngle[i - begin] = stars.angle[i];
+            savedGeneration[i - begin] = stars.generation[i];
+        }
+
+        if (!allRespawn) {
+            kernel(stars, scaled, begin, end);
+        }
+        for (int i = begin; i < end; ++i) {
+            if (allRespawn || stars.generation[i] != savedGeneration[i - begin]) {
+                stars.generation[i] = savedGeneration[i - begin];
+                advanceStarExact(stars, params, step, i, savedRadius[i - begin], savedAngle[i - begin]);
+            } else if (stars.angle[i] >= kTwoPi) {
+                // Con pasos largos el giro puede superar una vuelta completa
+                stars.angle[i] = std::fmod(stars.angle[i], kTwoPi);
+            }
+        }
+    });
+}
+
+// Avanza la galaxia τ ticks de una vez con el kernel vectorial de la actualización
+inline void advanceGalaxy(StarStore &stars, const GalaxyParams &params, double ticks,
+                          SimdLevel level = SimdLevel::Auto, const ParallelPolicy &policy = ParallelPolicy()) {
+    advanceGalaxyWith(stars, params, ticks, policy, selectUpdateKernel(resolveSimdLevel(level)));
+}
+
+// Cambia la cantidad de estrellas activas. Las que se agregan se generan como al inicio y se
+// avanzan elapsedTicks en forma cerrada, así aparecen donde estarían si nunca se hubieran quitado.
+// Si estaban en orden espacial vuelven primero al de generación, para quitar o agregar las últimas.
+inline void resizeGalaxy(StarStore &stars, const GalaxyParams &params, std::size_t count, double elapsedTicks,
+                         const ParallelPolicy &policy = ParallelPolicy()) {
+    restoreGenerationOrder(stars, policy);
+    int first = static_cast<int>(stars.count());
+    stars.resize(count);
+    int last = static_cast<int>(count);
+    if (last <= first) {
+        return;
+    }
+    TimeStep step = makeTimeStep(params, elapsedTicks);
+    parallelFor(policy, first, last, [&](int i) {
+        initStar(stars, params, i);
+        if (elapsedTicks > 0.0) {
+            advanceStarExact(stars, params, step, i, stars.radius[i], stars.angle[i]);
+        }
+    });
+}
+
+// Avanza la galaxia un tiempo en segundos
+inline void advanceGalaxySeconds(StarStore &stars, const GalaxyParams &params, double seconds,
+                                 SimdLevel level = SimdLevel::Auto,
+                                 const ParallelPolicy &policy = ParallelPolicy()) {
+    advanceGalaxy(stars, params, seconds * kTicksPerSecond, level, policy);
+}
+
+#endif //PARALLEL_SCREENSAVER_TIME_STEP_H
@@ -0,0 +1,388 @@
+/*
+ * Nombre: scaling_study.cpp
+ * Autores:
+   - Andrés Montoya, 21552
+   - Fernanda Esquivel, 21542
+   - Francisco Castillo, 21562
+ * Descripción: Estudio de escalabilidad fuerte y débil. Recorre cantidades de hilos y de estrellas,
+   mide por fase (inicialización, actualización y dibujo) la lógica de main.cpp y de main_omp.cpp,
+   y calcula speedup, eficiencia y la fracción serial ajustada con las leyes de Amdahl y Gustafson.
+ * Lenguaje: C++
+ * Recursos: CLion, SFML, OpenMP
+ * Historial:
+   - Creado el 17.10.2026
+   - Modificado el 17.10.2026 (readList pasó a options.h para los benchmarks)
+   - Modificado el 17.10.2026 (el pool y std::execution::par también cambian de cantidad de hilos)
+*/
+
+#include <SFML/Graphics.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <omp.h>
+
+#include "density.h"
+#include "galaxy.h"
+#include "options.h"
+#include "sequential.h"
+#include "star_renderer.h"
+
+// omp_set_num_threads no limita a std::execution::par: con el backend de TBB se limita con
+// tbb::global_control; con el backend en serie la política no escala y no se estudia
+#if defined(GALAXY_HAS_STD_PARALLEL) && defined(_PSTL_PAR_BACKEND_TBB)
+#include <tbb/global_control.h>
+#define STUDY_LIMITS_STDPAR 1
+#endif
+
+// Fases medidas. La inicialización se mide completa; la actualización y el dibujo, por frame.
+enum StudyPhase {
+    kStudyInit,
+    kStudyUpdate,
+    kStudyDraw,
+    kStudyPhaseCount
+};
+
+const char *const kStudyPhaseNames[kStudyPhaseCount] = {"init", "update", "dibujo"};
+
+struct StudyOptions {
+    std::vector<int> sizes{10000, 30000};  // Estrellas del estudio fuerte
+    std::vector<int> threads;              // Vacío: de 1 a la cantidad de núcleos; 1 siempre se incluye
+    int weakBase = 10000;                  // Estrellas por hilo del estudio débil (0 = omitirlo)
+    int frames = 200;
+    int repeats = 3;                       // Se queda el mínimo de las repeticiones
+    bool largeN = false;                   // Dibujo por densidad (--large) en lugar del lote de vértices
+    ParallelPolicy parallel;
+    std::uint64_t seed = 42;
+};
+
+// Segundos de cada fase en una corrida; el dibujo queda en NaN si la versión no lo mide
+struct PhaseTimes {
+    double seconds[kStudyPhaseCount];
+};
+
+void printStudyUsage(const char *program) {
+    std::cout << "Uso: " << program << " [opciones]\n"
+              << "  --sizes N,N,...       Estrellas del estudio fuerte (por defecto 10000,30000)\n"
+              << "  --threads N,N,...     Hilos a probar (por defecto de 1 a la cantidad de núcleos)\n"
+              << "  --weak N              Estrellas por hilo del estudio débil (por defecto 10000, 0 = omitir)\n"
+              << "  --frames N            Frames de actualización y dibujo por medición (por defecto 200)\n"
+              << "  --repeats N           Repeticiones por medición; se usa la más rápida (por defecto 3)\n"
+              << "  --large               Dibujar por densidad como --large en lugar del lote de vértices\n"
+              << "  --parallel P          omp-static, omp-dynamic, omp-guided, pool o stdpar\n"
+              << "  --seed N              Semilla de la galaxia (por defecto 42)\n"
+              << "  --help                Mostrar esta ayuda\n"
+              << "El CSV sale por la salida estándar y la tabla de resumen por la salida de error.\n";
+}
+
+bool parseStudyOptions(int argc, char **argv, StudyOptions &options) {
+    for (int i = 1; i < argc; ++i) {
+        const char *arg = argv[i];
+        double value = 0.0;
+
+        if (std::strcmp(arg, "--help") == 0 || std::strcmp(arg, "-h") == 0) {
+            printStudyUsage(argv[0]);
+            return false;
+        } else if (std::strcmp(arg, "--sizes") == 0) {
+            if (!readList(argc, argv, i, 1, static_cast<int>(kMaxLargePoints), options.sizes)) return false;
+        } else if (std::strcmp(arg, "--threads") == 0) {
+            if (!readList(argc, argv, i, 1, 4096, options.threads)) return false;
+        } else if (std::strcmp(arg, "--weak") == 0) {
+            if (!readValue(argc, argv, i, value) || !checkRange(arg, value, 0, kMaxLargePoints)) return false;
+            options.weakBase = static_cast<int>(value);
+        } else if (std::strcmp(arg, "--frames") == 0) {
+            if (!readValue(argc, argv, i, value) || !checkRange(arg, value, 1, 100000000)) return false;
+            options.frames = static_cast<int>(value);
+        } else if (std::strcmp(arg, "--repeats") == 0) {
+            if (!readValue(argc, argv, i, value) || !checkRange(arg, value, 1, 1000)) return false;
+            options.repeats = static_cast<int>(value);
+        } else if (std::strcmp(arg, "--large") == 0) {
+            options.largeN = true;
+        } else if (std::strcmp(arg, "--parallel") == 0) {
+            if (i + 1 >= argc || !parseParallelBackend(argv[i + 1], options.parallel.backend)) {
+                std::cerr << "Valor invalido para --parallel\n";
+                return false;
+            }
+            ++i;
+        } else if (std::strcmp(arg, "--seed") == 0) {
+            if (!readValue(argc, argv, i, value) || !checkRange(arg, value, 0, 4294967295.0)) return false;
+            options.seed = static_cast<std::uint64_t>(value);
+        } else {
+            std::cerr << "Opcion desconocida: " << arg << "\n";
+            printStudyUsage(argv[0]);
+            return false;
+        }
+    }
+#ifndef STUDY_LIMITS_STDPAR
+    if (options.parallel.backend == ParallelBackend::StdPar) {
+        std::cerr << "--parallel stdpar necesita std::execution::par con TBB para variar los hilos\n";
+        return false;
+    }
+#endif
+    if (options.threads.empty()) {
+        for (int t = 1; t <= omp_get_num_procs(); ++t) {
+            options.threads.push_back(t);
+        }
+    }
+    // Un hilo siempre se mide: es la referencia del speedup
+    options.threads.push_back(1);
+    std::sort(options.threads.begin(), options.threads.end());
+    options.threads.erase(std::unique(options.threads.begin(), options.threads.end()), options.threads.end());
+    return true;
+}
+
+GalaxyParams studyParams(const StudyOptions &options) {
+    GalaxyParams params;
+    params.seed = options.seed;
+    return params;
+}
+
+// La lógica de main.cpp en un hilo. Su dibujo es un draw por estrella en la ventana, que sin
+// contexto de OpenGL no se puede medir, así que esa fase queda vacía.
+PhaseTimes measureSequential(const StudyOptions &options, int numPoints) {
+    GalaxyParams params = studyParams(options);
+    sf::Vector2f center(params.centerX, params.centerY);
+    PhaseTimes best;
+    std::fill(best.seconds, best.seconds + kStudyPhaseCount, std::numeric_limits<double>::infinity());
+    best.seconds[kStudyDraw] = std::numeric_limits<double>::quiet_NaN();
+
+    for (int r = 0; r < options.repeats; ++r) {
+        srand(static_cast<unsigned>(options.seed));
+        std::vector<sf::CircleShape> points(numPoints);
+        double start = omp_get_wtime();
+        initGalaxy(points, center, params.maxRadius);
+        double initEnd = omp_get_wtime();
+        for (int frame = 0; frame < options.frames; ++frame) {
+            updateGalaxy(points, center, params.maxRadius, params.speed, params.baseRotationSpeed);
+        }
+        double updateEnd = omp_get_wtime();
+        best.seconds[kStudyInit] = std::min(best.seconds[kStudyInit], initEnd - start);
+        best.seconds[kStudyUpdate] = std::min(best.seconds[kStudyUpdate], (updateEnd - initEnd) / options.frames);
+    }
+    return best;
+}
+
+// La lógica de main_omp.cpp (y de su modo headless) con la cantidad de hilos pedida
+PhaseTimes measureParallel(const StudyOptions &options, int numPoints, int numThreads) {
+    omp_set_num_threads(numThreads);
+    // El pool se crea una sola vez con los hilos de OpenMP de ese momento
+    if (options.parallel.backend == ParallelBackend::Pool) {
+        WorkStealingPool::resizeShared(numThreads);
+    }
+#ifdef STUDY_LIMITS_STDPAR
+    tbb::global_control limit(tbb::global_control::max_allowed_parallelism, static_cast<std::size_t>(numThreads));
+#endif
+    GalaxyParams params = studyParams(options);
+    Palette palette;
+    PhaseTimes best;
+    std::fill(best.seconds, best.seconds + kStudyPhaseCount, std::numeric_limits<double>::infinity());
+
+    for (int r = 0; r < options.repeats; ++r) {
+        StarStore stars;
+        sf::VertexArray vertices;
+        DensityRenderer density;
+        Framebuffer densityFrame;
+
+        double start = omp_get_wtime();
+        stars.resize(numPoints);
+        initGalaxy(stars, params, options.parallel);
+        double initEnd = omp_get_wtime();
+        for (int frame = 0; frame < options.frames; ++frame) {
+            updateGalaxy(stars, params, SimdLevel::Auto, options.parallel);
+        }
+        double updateEnd = omp_get_wtime();
+        for (int frame = 0; frame < options.frames; ++frame) {
+            if (options.largeN) {
+                density.render(stars, palette, densityFrame);
+            } else {
+                buildStarVertices(stars, palette, vertices);
+            }
+        }
+        double drawEnd = omp_get_wtime();
+        best.seconds[kStudyInit] = std::min(best.seconds[kStudyInit], initEnd - start);
+        best.seconds[kStudyUpdate] = std::min(best.seconds[kStudyUpdate], (updateEnd - initEnd) / options.frames);
+        best.seconds[kStudyDraw] = std::min(best.seconds[kStudyDraw], (drawEnd - updateEnd) / options.frames);
+    }
+    return best;
+}
+
+// Amdahl: T(p) = T(1)·(f + (1 - f)/p). Con x = 1 - 1/p e y = T(p)/T(1) - 1/p queda y = f·x,
+// cuyo ajuste por mínimos cuadrados es f = Σxy / Σx². Devuelve NaN con menos de dos cantidades
+// de hilos.
+double fitAmdahl(const std::vector<int> &threads, const std::vector<double> &seconds) {
+    double sxy = 0.0;
+    double sxx = 0.0;
+    for (std::size_t k = 0; k < threads.size(); ++k) {
+        double x = 1.0 - 1.0 / threads[k];
+        double y = seconds[k] / seconds[0] - 1.0 / threads[k];
+        sxy += x * y;
+        sxx += x * x;
+    }
+    if (sxx <= 0.0) {
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+    return std::max(0.0, std::min(1.0, sxy / sxx));
+}
+
+// Gustafson: el speedup escalado es S(p) = p - s·(p - 1), así que p - S = s·(p - 1) y
+// s = Σ(p - 1)(p - S) / Σ(p - 1)²
+double fitGustafson(const std::vector<int> &threads, const std::vector<double> &speedups) {
+    double sxy = 0.0;
+    double sxx = 0.0;
+    for (std::size_t k = 0; k < threads.size(); ++k) {
+        double x = threads[k] - 1.0;
+        sxy += x * (threads[k] - speedups[k]);
+        sxx += x * x;
+    }
+    if (sxx <= 0.0) {
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+    return std::max(0.0, std::min(1.0, sxy / sxx));
+}
+
+// Celda de CSV: vacía si el valor no existe
+std::string cell(double value) {
+    if (std::isnan(value)) {
+        return "";
+    }
+    std::ostringstream text;
+    text << value;
+    return text.str();
+}
+
+// Fila de la tabla de resumen
+struct SummaryRow {
+    std::string study;
+    int points;
+    int phase;
+    double speedup;      // Con la mayor cantidad de hilos
+    double efficiency;
+    double serial;       // Fracción serial ajustada
+};
+
+void printSummary(const std::vector<SummaryRow> &rows, int maxThreads) {
+    std::cerr << "\nResumen con " << maxThreads << " hilos (f = fracción serial ajustada; "
+              << "fuerte: Amdahl, S max = 1/f; débil: Gustafson)\n";
+    std::cerr << std::left << std::setw(8) << "estudio" << std::right << std::setw(12) << "puntos"
+              << std::setw(9) << "fase" << std::setw(10) << "speedup" << std::setw(12) << "eficiencia"
+              << std::setw(9) << "f" << std::setw(10) << "S max" << "\n";
+    std::cerr << std::fixed << std::setprecision(3);
+    for (const SummaryRow &row : rows) {
+        std::cerr << std::left << std::setw(8) << row.study << std::right << std::setw(12) << row.points
+                  << std::setw(9) << kStudyPhaseNames[row.phase] << std::setw(10) << row.speedup
+                  << std::setw(12) << row.efficiency;
+        if (std::isnan(row.serial)) {
+            std::cerr << std::setw(9) << "n/d" << std::setw(10) << "n/d";
+        } else {
+            std::cerr << std::setw(9) << row.serial;
+            if (row.study == "fuerte" && row.serial > 0.0) {
+                std::cerr << std::setw(10) << 1.0 / row.serial;
+            } else {
+                std::cerr << std::setw(10) << (row.study == "fuerte" ? "inf" : "-");
+            }
+        }
+        std::cerr << "\n";
+    }
+
+    // La fase con mayor fracción serial es la que primero deja de escalar
+    const SummaryRow *worst = nullptr;
+    for (const SummaryRow &row : rows) {
+        if (row.study == "fuerte" && !std::isnan(row.serial) && (!worst || row.serial > worst->serial)) {
+            worst = &row;
+        }
+    }
+    if (worst) {
+        std::cerr << "La fase que más limita el escalamiento es " << kStudyPhaseNames[worst->phase]
+                  << " (f = " << worst->serial << " con " << worst->points << " estrellas)\n";
+    } else {
+        std::cerr << "Con una sola cantidad de hilos no se puede ajustar la fracción serial\n";
+    }
+    std::cerr.unsetf(std::ios::floatfield);
+}
+
+int main(int argc, char **argv) {
+    StudyOptions options;
+    if (!parseStudyOptions(argc, argv, options)) {
+        return 1;
+    }
+    const std::vector<int> &threads = options.threads;
+    std::vector<SummaryRow> summary;
+
+    std::cout << "estudio,version,politica,fase,puntos,hilos,tiempo_ms,speedup,speedup_vs_secuencial,eficiencia\n";
+
+    // Escalamiento fuerte: misma galaxia con más hilos. El speedup es contra la versión
+    // paralela con un hilo y, para init y actualización, también contra main.cpp.
+    for (int numPoints : options.sizes) {
+        std::cerr << "Estudio fuerte con " << numPoints << " estrellas...\n";
+        PhaseTimes sequential = measureSequential(options, numPoints);
+        for (int phase = 0; phase < kStudyDraw; ++phase) {
+            std::cout << "fuerte,secuencial,-," << kStudyPhaseNames[phase] << ',' << numPoints << ",1,"
+                      << 1000.0 * sequential.seconds[phase] << ",,1,\n";
+        }
+
+        std::vector<PhaseTimes> parallel;
+        for (int t : threads) {
+            parallel.push_back(measureParallel(options, numPoints, t));
+        }
+        for (int phase = 0; phase < kStudyPhaseCount; ++phase) {
+            std::vector<double> seconds;
+            for (std::size_t k = 0; k < threads.size(); ++k) {
+                double time = parallel[k].seconds[phase];
+                double speedup = parallel[0].seconds[phase] / time;
+                seconds.push_back(time);
+                std::cout << "fuerte,omp," << parallelBackendName(options.parallel.backend) << ','
+                          << kStudyPhaseNames[phase] << ',' << numPoints << ',' << threads[k] << ','
+                          << 1000.0 * time << ',' << speedup << ','
+                          << cell(sequential.seconds[phase] / time) << ',' << speedup / threads[k] << '\n';
+            }
+            SummaryRow row;
+            row.study = "fuerte";
+            row.points = numPoints;
+            row.phase = phase;
+            row.speedup = parallel[0].seconds[phase] / parallel.back().seconds[phase];
+            row.efficiency = row.speedup / threads.back();
+            row.serial = threads.size() > 1 ? fitAmdahl(threads, seconds) : std::numeric_limits<double>::quiet_NaN();
+            summary.push_back(row);
+        }
+    }
+
+    // Escalamiento débil: weakBase estrellas por hilo. El speedup escalado es
+    // p·T(1, N)/T(p, p·N), suponiendo que con un hilo el costo crece linealmente con N.
+    if (options.weakBase > 0) {
+        std::cerr << "Estudio debil con " << options.weakBase << " estrellas por hilo...\n";
+        std::vector<PhaseTimes> parallel;
+        for (int t : threads) {
+            parallel.push_back(measureParallel(options, options.weakBase * t, t));
+        }
+        for (int phase = 0; phase < kStudyPhaseCount; ++phase) {
+            std::vector<double> speedups;
+            for (std::size_t k = 0; k < threads.size(); ++k) {
+                double time = parallel[k].seconds[phase];
+                double speedup = threads[k] * parallel[0].seconds[phase] / time;
+                speedups.push_back(speedup);
+                std::cout << "debil,omp," << parallelBackendName(options.parallel.backend) << ','
+                          << kStudyPhaseNames[phase] << ',' << options.weakBase * threads[k] << ','
+                          << threads[k] << ',' << 1000.0 * time << ',' << speedup << ",,"
+                          << speedup / threads[k] << '\n';
+            }
+            SummaryRow row;
+            row.study = "debil";
+            row.points = options.weakBase * threads.back();
+            row.phase = phase;
+            row.speedup = speedups.back();
+            row.efficiency = row.speedup / threads.back();
+            row.serial = threads.back() > 1 ? fitGustafson(threads, speedups) : std::numeric_limits<double>::quiet_NaN();
+            summary.push_back(row);
+        }
+    }
+
+    printSummary(summary, threads.back());
+    return 0;
+}
@@ -0,0 +1,159 @@
+/*
+ * Nombre: shm_consumer.cpp
+ * Autores:
+   - Andrés Montoya, 21552
+   - Fernanda Esquivel, 21542
+   - Francisco Castillo, 21562
+ * Descripción: Lector de referencia del anillo de frames en memoria compartida (--shm). Espera cada
+   frame con el futex, lo usa directamente desde el mapeo (opcionalmente lo escribe como RGB24) y
+   reporta frames recibidos, perdidos y rotos, y la latencia desde que el productor lo publicó.
+ * Lenguaje: C++
+ * Recursos: CLion
+ * Historial:
+   - Creado el 17.10.2026
+*/
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <thread>
+
+#include "frame_stats.h"
+#include "options.h"
+#include "shm_frames.h"
+
+struct ConsumerOptions {
+    std::string name = "galaxy";       // Nombre del anillo, el mismo de --shm
+    int frames = 0;                    // Frames que se leen (0 = hasta que el productor termine)
+    std::string rawOutput;             // Flujo RGB24 sin encabezado ("-" = salida estándar)
+    double holdMs = 0.0;               // Tiempo que se retiene cada frame, para simular un lector lento
+    double openTimeout = 10.0;         // Segundos que se espera a que el productor cree el anillo
+};
+
+void printConsumerUsage(const char *program) {
+    std::cout << "Uso: " << program << " [opciones]\n"
+              << "  --name NOMBRE         Anillo de memoria compartida del productor (--shm), por defecto galaxy\n"
+              << "  --frames N            Frames que se leen (0 = hasta que el productor termine)\n"
+              << "  --raw ARCHIVO         Escribir cada frame como RGB24 crudo ('-' = stdout)\n"
+              << "  --hold-ms MS          Retener cada frame MS milisegundos (lector lento)\n"
+              << "  --open-timeout S      Segundos de espera a que exista el anillo (por defecto 10)\n";
+}
+
+bool parseConsumerOptions(int argc, char **argv, ConsumerOptions &options) {
+    for (int i = 1; i < argc; ++i) {
+        const char *arg = argv[i];
+        double value = 0.0;
+
+        if (std::strcmp(arg, "--help") == 0 || std::strcmp(arg, "-h") == 0) {
+            printConsumerUsage(argv[0]);
+            return false;
+        } else if (std::strcmp(arg, "--name") == 0 || std::strcmp(arg, "--raw") == 0) {
+            if (i + 1 >= argc) {
+                std::cerr << "Falta el valor de " << arg << "\n";
+                return false;
+            }
+            (std::strcmp(arg, "--name") == 0 ? options.name : options.rawOutput) = argv[++i];
+        } else if (std::strcmp(arg, "--frames") == 0) {
+            if (!readValue(argc, argv, i, value) || !checkRange(arg, value, 0, 100000000)) return false;
+            options.frames = static_cast<int>(value);
+        } else if (std::strcmp(arg, "--hold-ms") == 0) {
+            if (!readValue(argc, argv, i, value) || !checkRange(arg, value, 0, 10000)) return false;
+            options.holdMs = value;
+        } else if (std::strcmp(arg, "--open-timeout") == 0) {
+            if (!readValue(argc, argv, i, value) || !checkRange(arg, value, 0, 3600)) return false;
+            options.openTimeout = value;
+        } else {
+            std::cerr << "Opcion desconocida: " << arg << "\n";
+            printConsumerUsage(argv[0]);
+            return false;
+        }
+    }
+    return true;
+}
+
+int main(int argc, char **argv) {
+    ConsumerOptions options;
+    if (!parseConsumerOptions(argc, argv, options)) {
+        return 1;
+    }
+
+    // El productor puede arrancar después que el lector
+    ShmFrameConsumer ring;
+    auto openDeadline = std::chrono::steady_clock::now() + std::chrono::duration<double>(options.openTimeout);
+    while (!ring.open(options.name)) {
+        if (std::chrono::steady_clock::now() >= openDeadline) {
+            std::cerr << "No se encontro el anillo " << options.name << "\n";
+            return 1;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    }
+
+    std::FILE *raw = nullptr;
+    if (options.rawOutput == "-") {
+        raw = stdout;
+    } else if (!options.rawOutput.empty()) {
+        raw = std::fopen(options.rawOutput.c_str(), "wb");
+        if (!raw) {
+            std::cerr << "No se pudo abrir " << options.rawOutput << "\n";
+            return 1;
+        }
+    }
+
+    // Latencia de publicación a lectura (al tomar el frame) y hasta terminar de usarlo
+    LatencyHistogram latency;
+    LatencyHistogram held;
+    std::uint64_t received = 0;
+    std::uint64_t dropped = 0;
+    std::uint64_t torn = 0;
+    bool writeError = false;
+    while (options.frames == 0 || received < static_cast<std::uint64_t>(options.frames)) {
+        if (!ring.wait(1000)) {
+            if (ring.closed()) {
+                break;
+            }
+            continue;
+        }
+        ShmFrameView view;
+        if (!ring.acquire(view)) {
+            continue; // El productor estaba escribiendo esa ranura; hay otro frame más nuevo
+        }
+        latency.record((shm_detail::monotonicNs() - view.publishedNs) * 1e-9);
+
+        std::size_t bytes = static_cast<std::size_t>(view.width) * view.height * 3;
+        if (raw && std::fwrite(view.pixels, 1, bytes, raw) != bytes) {
+            writeError = true;
+        }
+        if (options.holdMs > 0.0) {
+            std::this_thread::sleep_for(std::chrono::duration<double, std::milli>(options.holdMs));
+        }
+        held.record((shm_detail::monotonicNs() - view.publishedNs) * 1e-9);
+
+        dropped += view.skipped;
+        if (ring.release(view)) {
+            ++received;
+        } else {
+            ++torn;
+        }
+        if (writeError) {
+            std::cerr << "Error al escribir el frame " << view.frame << "\n";
+            break;
+        }
+    }
+    if (raw && raw != stdout) {
+        std::fclose(raw);
+    } else if (raw) {
+        std::fflush(raw);
+    }
+
+    std::ostream &report = raw == stdout ? std::cerr : std::cout;
+    report << "version,nombre,ancho,alto,ranuras,recibidos,perdidos,rotos,latencia_ms_media,latencia_ms_p50,"
+              "latencia_ms_p99,latencia_ms_max,retenido_ms_p50,retenido_ms_p99\n";
+    report << "shm_lector," << options.name << ',' << ring.width() << ',' << ring.height() << ','
+           << ring.slots() << ',' << received << ',' << dropped << ',' << torn << ','
+           << 1000.0 * latency.mean() << ',' << 1000.0 * latency.percentile(50) << ','
+           << 1000.0 * latency.percentile(99) << ',' << 1000.0 * latency.max() << ','
+           << 1000.0 * held.percentile(50) << ',' << 1000.0 * held.percentile(99) << std::endl;
+    return writeError ? 1 : 0;
+}